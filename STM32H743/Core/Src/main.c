@@ -22,7 +22,7 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-
+#include "rte_flash_dump.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -105,6 +105,10 @@ int main(void)
   //++++++++++++++++++++++++++++++++++++++++++++++++
   // Enable one or more RTEdbg demo functions, compile and start the code.
   // Batch files for the data transfer from the embedded system are in the TEST folder.
+#if RTE_FLASH_DUMP_ENABLED != 0
+  rte_flash_dump_init();  // Prepare the flash slot for the data dump in the fault handler
+#endif
+
 #if 0
   // RTEdbg test code - enable after porting to a new compiler or CPU core
   void rtedbg_test(void);
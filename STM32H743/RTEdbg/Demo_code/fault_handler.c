@@ -19,6 +19,7 @@
 
 #include "main.h"
 #include "fault_handler.h"
+#include "rte_flash_dump.h"
 
 
 // Global variables -----------------------------------------------------------------
@@ -143,9 +144,16 @@ void __NO_RETURN __USED main_exception_handler(const uint32_t msp_used,
      * The error information logged in the circular buffer is preserved after e.g. a watchdog
      * reset (system restart) if the RTE_FILTER_OFF_ENABLED != 0 and the firmware does not use
      * the RTE_FORCE_ENABLE_ALL_FILTERS to force the filter to be enabled again.
+     * The repetitions of messages counted by RTE_SUPPRESS_REPEATED are logged first -
+     * they would be lost after the logging is disabled.
      */
+    rte_flush_repeated();
     rte_set_filter(0U);
 
+#if RTE_FLASH_DUMP_ENABLED != 0
+    rte_flash_dump_save();      // Copy the logged data to the flash memory (see rte_flash_dump.c)
+#endif
+
     shutdown_and_restart();
 }
 /*-------------------------------------------------------------------------------*/
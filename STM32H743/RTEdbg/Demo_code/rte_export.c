@@ -0,0 +1,548 @@
+/*
+ * Copyright (c) Branko Premzel.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/***
+ * @file   rte_export.c
+ * @author Branko Premzel
+ * @brief  Example of the g_rtedbg structure compression before the export over a slow
+ *         communication link and the decompression on the host.
+ *
+ * The compressor processes the g_rtedbg structure word by word and needs only a small
+ * static RAM (output chunk buffer and format ID dictionary). The words are coded as:
+ *   - header words: unchanged (32-bit little endian)
+ *   - FMT words: the format ID field (format ID + bits 31 of the DATA words) is coded
+ *     with the dictionary index or as a new value, the timestamp as a difference to the
+ *     timestamp of the previous FMT word
+ *   - DATA words: zig-zag coded signed value - small positive and negative values
+ *     are coded with one or two bytes
+ *   - erased words (0xFFFFFFFF): number of consecutive words
+ * The rte_export_decompress() restores the identical g_rtedbg image. It is decoded by
+ * RTEmsg in the same way as the data read by a debug probe (e.g. Data.bin).
+ *
+ * Stream format: magic (4 bytes), number of image words (4 bytes), header words, tokens
+ *   00vvvvvv                    DATA word, zig-zag value v (0 .. 63)
+ *   01vvvvvv + varint(n)        DATA word, zig-zag value v + (n << 6)
+ *   100kkkkk + varint(dt)       FMT word, format ID field from the dictionary entry k
+ *   101----- + varint(f, dt)    FMT word, new format ID field f (added to the dictionary)
+ *   110nnnnn                    n + 1 erased words (n = 0 .. 30)
+ *   11011111 + varint(n)        n + 32 erased words
+ *   111-----                    reserved
+ * The varint is coded with 7 bits per byte (LSB first, bit 7 = more bytes follow).
+ *
+ * Stop the data logging (e.g. rte_set_filter(0U)) before the rte_export_compress() call
+ * to get a consistent image and restore the filter after the export.
+ *
+ * Host decompressor build (command line tool that restores the g_rtedbg image):
+ *   gcc -O2 -DRTE_EXPORT_HOST_TOOL -I../Inc rte_export.c -o rte_unpack
+ *   rte_unpack compressed.bin Data.bin
+ */
+
+#if !defined RTE_EXPORT_HOST_TOOL
+#include "main.h"
+#include "rtedbg.h"
+#include "rtedbg_int.h"
+#else
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+#include "rte_export.h"
+
+#define RTE_EXPORT_DATA        0x00U    // DATA word (6-bit value)
+#define RTE_EXPORT_DATA_LONG   0x40U    // DATA word (6-bit value + varint)
+#define RTE_EXPORT_FMT_DICT    0x80U    // FMT word with the dictionary entry
+#define RTE_EXPORT_FMT_NEW     0xA0U    // FMT word with a new format ID field
+#define RTE_EXPORT_ERASED      0xC0U    // Erased words
+#define RTE_EXPORT_RESERVED    0xE0U    // Reserved for future extensions
+#define RTE_EXPORT_TAG_MASK    0xE0U
+#define RTE_EXPORT_MAX_RUN     31U      // Erased words count coded with the tag only
+
+#define RTE_EXPORT_DICT_SLOT(field)  (((field) ^ ((field) >> 5U)) & (RTE_EXPORT_DICT_SIZE - 1U))
+#define RTE_EXPORT_NOT_USED    0xFFFFFFFFUL     // Unused dictionary entry
+
+#if (RTE_EXPORT_DICT_SIZE & (RTE_EXPORT_DICT_SIZE - 1U)) != 0U
+#error "RTE_EXPORT_DICT_SIZE must be a power of 2."
+#endif
+
+#if RTE_EXPORT_DICT_SIZE > 32U
+#error "The dictionary index must fit into five bits."
+#endif
+
+
+#if !defined RTE_EXPORT_HOST_TOOL
+static uint8_t rte_export_out[RTE_EXPORT_CHUNK_SIZE];   // Output chunk buffer
+static uint32_t rte_export_count;                       // Number of bytes in the chunk buffer
+static uint32_t rte_export_total;                       // Size of the compressed data
+static rte_export_write_t rte_export_write;
+static uint32_t rte_export_dict[RTE_EXPORT_DICT_SIZE];  // Format ID field dictionary
+
+
+/***
+ * @brief Add a byte to the output chunk buffer and pass the full buffer to the write function.
+ *
+ * @param byte  Compressed data byte
+ */
+
+static void rte_export_put(const uint32_t byte)
+{
+    rte_export_out[rte_export_count] = (uint8_t)byte;
+    rte_export_count++;
+    rte_export_total++;
+
+    if (rte_export_count >= RTE_EXPORT_CHUNK_SIZE)
+    {
+        rte_export_write(rte_export_out, rte_export_count);
+        rte_export_count = 0U;
+    }
+}
+
+
+/***
+ * @brief Output the value with 7 bits per byte - small values need fewer bytes.
+ *
+ * @param value  Value to be coded
+ */
+
+static void rte_export_varint(uint32_t value)
+{
+    while (value > 0x7FU)
+    {
+        rte_export_put((value & 0x7FU) | 0x80U);
+        value >>= 7U;
+    }
+
+    rte_export_put(value);
+}
+
+
+/***
+ * @brief Output a 32-bit word unchanged (little endian).
+ *
+ * @param word  Value to be written
+ */
+
+static void rte_export_word(const uint32_t word)
+{
+    rte_export_put(word & 0xFFU);
+    rte_export_put((word >> 8U) & 0xFFU);
+    rte_export_put((word >> 16U) & 0xFFU);
+    rte_export_put(word >> 24U);
+}
+
+
+/***
+ * @brief Output the number of consecutive erased words.
+ *
+ * @param count  Number of erased words (> 0)
+ */
+
+static void rte_export_erased(const uint32_t count)
+{
+    if (count > RTE_EXPORT_MAX_RUN)
+    {
+        rte_export_put(RTE_EXPORT_ERASED | RTE_EXPORT_MAX_RUN);
+        rte_export_varint(count - (RTE_EXPORT_MAX_RUN + 1U));
+    }
+    else
+    {
+        rte_export_put(RTE_EXPORT_ERASED | (count - 1U));
+    }
+}
+
+
+/***
+ * @brief Compress the g_rtedbg structure and pass the compressed data to the write function.
+ *
+ * @param write  Function that sends or stores a chunk of the compressed data
+ *
+ * @return Size of the compressed data (bytes)
+ */
+
+uint32_t rte_export_compress(rte_export_write_t write)
+{
+    const uint32_t *image = (const uint32_t *)&g_rtedbg;
+    const uint32_t header_words = RTE_HEADER_SIZE / 4U;
+    const uint32_t image_words = header_words + RTE_BUFFER_WORDS + 4U;
+    const uint32_t tstamp_mask = 0xFFFFFFFFU >> ((uint32_t)(RTE_FMT_ID_BITS) + 1U);
+    uint32_t last_tstamp = 0U;
+    uint32_t erased = 0U;
+
+    rte_export_write = write;
+    rte_export_count = 0U;
+    rte_export_total = 0U;
+
+    for (uint32_t i = 0U; i < RTE_EXPORT_DICT_SIZE; i++)
+    {
+        rte_export_dict[i] = RTE_EXPORT_NOT_USED;
+    }
+
+    rte_export_word(RTE_EXPORT_MAGIC);
+    rte_export_word(image_words);
+
+    for (uint32_t i = 0U; i < header_words; i++)
+    {
+        rte_export_word(image[i]);
+    }
+
+    for (uint32_t i = header_words; i < image_words; i++)
+    {
+        uint32_t word = image[i];
+
+        if (word == RTE_ERASED_STATE)
+        {
+            erased++;
+            continue;
+        }
+
+        if (erased != 0U)
+        {
+            rte_export_erased(erased);
+            erased = 0U;
+        }
+
+        if ((word & 1U) == 0U)
+        {
+            // DATA word - zig-zag coding of the 31-bit signed value
+            int32_t value = ((int32_t)word) >> 1;
+            uint32_t zigzag = (((uint32_t)value) << 1U) ^ (uint32_t)(value >> 31);
+
+            if (zigzag < 0x40U)
+            {
+                rte_export_put(RTE_EXPORT_DATA | zigzag);
+            }
+            else
+            {
+                rte_export_put(RTE_EXPORT_DATA_LONG | (zigzag & 0x3FU));
+                rte_export_varint(zigzag >> 6U);
+            }
+        }
+        else
+        {
+            // FMT word - format ID field and timestamp difference
+            uint32_t field = word >> (32U - (uint32_t)(RTE_FMT_ID_BITS));
+            uint32_t tstamp = (word >> 1U) & tstamp_mask;
+            uint32_t slot = RTE_EXPORT_DICT_SLOT(field);
+
+            if (rte_export_dict[slot] == field)
+            {
+                rte_export_put(RTE_EXPORT_FMT_DICT | slot);
+            }
+            else
+            {
+                rte_export_dict[slot] = field;
+                rte_export_put(RTE_EXPORT_FMT_NEW);
+                rte_export_varint(field);
+            }
+
+            rte_export_varint((tstamp - last_tstamp) & tstamp_mask);
+            last_tstamp = tstamp;
+        }
+    }
+
+    if (erased != 0U)
+    {
+        rte_export_erased(erased);
+    }
+
+    if (rte_export_count != 0U)
+    {
+        write(rte_export_out, rte_export_count);
+    }
+
+    return rte_export_total;
+}
+#endif // !defined RTE_EXPORT_HOST_TOOL
+
+
+/***
+ * @brief Read a varint value from the compressed data.
+ *
+ * @param data    Compressed data
+ * @param length  Size of the compressed data
+ * @param pos     Position in the compressed data (updated)
+ * @param value   Decoded value
+ *
+ * @return 1 - value decoded, 0 - end of data or invalid value
+ */
+
+static uint32_t rte_export_get_varint(const uint8_t *data, const uint32_t length,
+                                      uint32_t *pos, uint32_t *value)
+{
+    uint32_t result = 0U;
+
+    for (uint32_t shift = 0U; shift < 35U; shift += 7U)
+    {
+        if (*pos >= length)
+        {
+            return 0U;
+        }
+
+        uint32_t byte = data[*pos];
+        (*pos)++;
+        result |= (byte & 0x7FU) << shift;
+
+        if ((byte & 0x80U) == 0U)
+        {
+            *value = result;
+            return 1U;
+        }
+    }
+
+    return 0U;
+}
+
+
+/***
+ * @brief Read a 32-bit little endian word from the compressed data.
+ *
+ * @return 1 - value decoded, 0 - end of data
+ */
+
+static uint32_t rte_export_get_word(const uint8_t *data, const uint32_t length,
+                                    uint32_t *pos, uint32_t *value)
+{
+    if ((*pos + 4U) > length)
+    {
+        return 0U;
+    }
+
+    const uint8_t *p = &data[*pos];
+    *value = (uint32_t)p[0] | ((uint32_t)p[1] << 8U) | ((uint32_t)p[2] << 16U) | ((uint32_t)p[3] << 24U);
+    *pos += 4U;
+    return 1U;
+}
+
+
+/***
+ * @brief Restore the g_rtedbg image from the data compressed with rte_export_compress().
+ *        The function does not depend on the embedded system configuration - the
+ *        format ID size and header size are read from the rte_cfg header word.
+ *
+ * @param data         Compressed data
+ * @param length       Size of the compressed data (bytes)
+ * @param image        Buffer for the g_rtedbg image
+ * @param image_words  Size of the buffer (number of 32-bit words)
+ *
+ * @return Number of the restored image words, 0 - invalid or incomplete data
+ */
+
+uint32_t rte_export_decompress(const uint8_t *data, uint32_t length,
+                               uint32_t *image, uint32_t image_words)
+{
+    uint32_t dict[RTE_EXPORT_DICT_SIZE];
+    uint32_t pos = 0U;
+    uint32_t magic = 0U;
+    uint32_t words = 0U;
+
+    if ((rte_export_get_word(data, length, &pos, &magic) == 0U) || (magic != RTE_EXPORT_MAGIC)
+        || (rte_export_get_word(data, length, &pos, &words) == 0U) || (words > image_words)
+        || (words < 3U))
+    {
+        return 0U;
+    }
+
+    // The first three header words contain the configuration word (rte_cfg)
+    for (uint32_t i = 0U; i < 3U; i++)
+    {
+        if (rte_export_get_word(data, length, &pos, &image[i]) == 0U)
+        {
+            return 0U;
+        }
+    }
+
+    const uint32_t fmt_id_bits = ((image[2] >> 12U) & 7U) + 9U;
+    const uint32_t header_words = (image[2] >> 24U) & 0x7FU;
+    const uint32_t tstamp_mask = 0xFFFFFFFFU >> (fmt_id_bits + 1U);
+    uint32_t last_tstamp = 0U;
+
+    if ((header_words < 3U) || (header_words > words))
+    {
+        return 0U;
+    }
+
+    for (uint32_t i = 3U; i < header_words; i++)
+    {
+        if (rte_export_get_word(data, length, &pos, &image[i]) == 0U)
+        {
+            return 0U;
+        }
+    }
+
+    for (uint32_t i = 0U; i < RTE_EXPORT_DICT_SIZE; i++)
+    {
+        dict[i] = RTE_EXPORT_NOT_USED;
+    }
+
+    uint32_t n = header_words;
+
+    while (n < words)
+    {
+        if (pos >= length)
+        {
+            return 0U;
+        }
+
+        uint32_t token = data[pos];
+        pos++;
+        uint32_t value = 0U;
+
+        if ((token & 0x80U) == 0U)
+        {
+            // DATA word
+            uint32_t zigzag = token & 0x3FU;
+            if ((token & RTE_EXPORT_DATA_LONG) != 0U)
+            {
+                if (rte_export_get_varint(data, length, &pos, &value) == 0U)
+                {
+                    return 0U;
+                }
+                zigzag |= value << 6U;
+            }
+
+            uint32_t signed_value = (zigzag >> 1U) ^ (0U - (zigzag & 1U));
+            image[n] = signed_value << 1U;
+            n++;
+        }
+        else if ((token & RTE_EXPORT_TAG_MASK) == RTE_EXPORT_ERASED)
+        {
+            uint32_t count = (token & 0x1FU) + 1U;
+            if ((token & 0x1FU) == RTE_EXPORT_MAX_RUN)
+            {
+                if (rte_export_get_varint(data, length, &pos, &value) == 0U)
+                {
+                    return 0U;
+                }
+                count = value + RTE_EXPORT_MAX_RUN + 1U;
+            }
+
+            if (count > (words - n))
+            {
+                return 0U;
+            }
+
+            for (uint32_t i = 0U; i < count; i++)
+            {
+                image[n] = 0xFFFFFFFFU;
+                n++;
+            }
+        }
+        else if ((token & RTE_EXPORT_TAG_MASK) != RTE_EXPORT_RESERVED)
+        {
+            // FMT word
+            uint32_t field;
+            if ((token & RTE_EXPORT_TAG_MASK) == RTE_EXPORT_FMT_DICT)
+            {
+                field = dict[token & 0x1FU];
+                if (field == RTE_EXPORT_NOT_USED)
+                {
+                    return 0U;
+                }
+            }
+            else
+            {
+                if (rte_export_get_varint(data, length, &pos, &field) == 0U)
+                {
+                    return 0U;
+                }
+                dict[RTE_EXPORT_DICT_SLOT(field)] = field;
+            }
+
+            if (rte_export_get_varint(data, length, &pos, &value) == 0U)
+            {
+                return 0U;
+            }
+
+            last_tstamp = (last_tstamp + value) & tstamp_mask;
+            image[n] = (field << (32U - fmt_id_bits)) | (last_tstamp << 1U) | 1U;
+            n++;
+        }
+        else
+        {
+            return 0U;      // Reserved token
+        }
+    }
+
+    return words;
+}
+
+
+#if defined RTE_EXPORT_HOST_TOOL
+/***
+ * @brief Host command line tool - restore the g_rtedbg image from the compressed file.
+ *        Usage: rte_unpack <compressed file> <output file>
+ */
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: rte_unpack <compressed file> <output file>\n");
+        return 1;
+    }
+
+    FILE *in = fopen(argv[1], "rb");
+    if (in == NULL)
+    {
+        fprintf(stderr, "Cannot open \"%s\"\n", argv[1]);
+        return 1;
+    }
+
+    (void)fseek(in, 0L, SEEK_END);
+    long size = ftell(in);
+    (void)fseek(in, 0L, SEEK_SET);
+
+    uint8_t *data = (size > 0L) ? (uint8_t *)malloc((size_t)size) : NULL;
+    if ((data == NULL) || (fread(data, 1U, (size_t)size, in) != (size_t)size))
+    {
+        fprintf(stderr, "Cannot read \"%s\"\n", argv[1]);
+        fclose(in);
+        free(data);
+        return 1;
+    }
+    fclose(in);
+
+    uint32_t *image = NULL;
+    uint32_t words = 0U;
+    if (size >= 8L)
+    {
+        uint32_t image_words = (uint32_t)data[4] | ((uint32_t)data[5] << 8U)
+                               | ((uint32_t)data[6] << 16U) | ((uint32_t)data[7] << 24U);
+        image = (uint32_t *)malloc((size_t)image_words * 4U + 4U);
+        if (image != NULL)
+        {
+            words = rte_export_decompress(data, (uint32_t)size, image, image_words);
+        }
+    }
+
+    if (words == 0U)
+    {
+        fprintf(stderr, "Invalid or incomplete compressed data in \"%s\"\n", argv[1]);
+        free(data);
+        free(image);
+        return 1;
+    }
+
+    FILE *out = fopen(argv[2], "wb");
+    if ((out == NULL) || (fwrite(image, 4U, words, out) != words))
+    {
+        fprintf(stderr, "Cannot write \"%s\"\n", argv[2]);
+        if (out != NULL)
+        {
+            fclose(out);
+        }
+        free(data);
+        free(image);
+        return 1;
+    }
+
+    fclose(out);
+    printf("%u bytes -> %u bytes\n", (unsigned)size, (unsigned)(words * 4U));
+    free(data);
+    free(image);
+    return 0;
+}
+#endif // defined RTE_EXPORT_HOST_TOOL
+
+/*==== End of file ====*/
@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) Branko Premzel.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/***
+ * @file   rte_flash_dump.c
+ * @author Branko Premzel
+ * @brief  Example of saving the logged data to the internal flash memory of the
+ *         STM32H743 after a fatal exception or before the power supply fails.
+ *
+ * The flash area is divided into slots. Each dump is written to the next slot and the
+ * flash sectors are erased in turn (wear leveling). The slots for the next dump are
+ * prepared (erased) at the startup by rte_flash_dump_init() - a sector erase takes
+ * too long for a fault handler or a PVD interrupt.
+ * The rte_flash_dump_save() does not use the HAL functions and interrupts. It copies the
+ * g_rtedbg header and the newest RTE_DUMP_MAX_WORDS words of the circular buffer (the
+ * position of the newest data is known from the buffer index). Flash words containing
+ * only erased data (0xFFFFFFFF) are skipped.
+ *
+ * The host software reads the g_rtedbg copy from the latest slot (slot record address
+ * + sizeof(rte_dump_record_t)) and decodes it in the same way as the g_rtedbg structure
+ * read from the RAM. The firmware can find the latest dump with rte_flash_dump_latest().
+ */
+
+#include "main.h"
+#include "rtedbg.h"
+#include "rtedbg_int.h"
+#include "rte_flash_dump.h"
+
+#define RTE_DUMP_FLASH_WORD  (FLASH_NB_32BITWORD_IN_FLASHWORD * 4U)   // Flash programming unit (bytes)
+#define RTE_DUMP_AREA_END    (RTE_DUMP_AREA_START + (RTE_DUMP_SECTORS * RTE_DUMP_SECTOR_SIZE))
+#define RTE_DUMP_HEADER_WORDS  (RTE_HEADER_SIZE / 4U)    // Size of the g_rtedbg header
+
+#define RTE_DUMP_CLEAR_ERRORS \
+    (FLASH_CCR_CLR_EOP | FLASH_CCR_CLR_WRPERR | FLASH_CCR_CLR_PGSERR | \
+     FLASH_CCR_CLR_STRBERR | FLASH_CCR_CLR_INCERR | FLASH_CCR_CLR_OPERR)
+
+#if (RTE_DUMP_AREA_START < FLASH_BANK2_BASE) || ((RTE_DUMP_AREA_END - 1U) > FLASH_END)
+#error "The flash dump area must be in the flash bank 2."
+#endif
+
+#if RTE_DUMP_SECTOR_SIZE != FLASH_SECTOR_SIZE
+#error "RTE_DUMP_SECTOR_SIZE must be equal to the flash sector size of the CPU (FLASH_SECTOR_SIZE)."
+#endif
+
+#if ((RTE_DUMP_SECTOR_SIZE % RTE_DUMP_SLOT_SIZE) != 0U) || (RTE_DUMP_SECTORS < 2U)
+#error "The sector size must be divisible by the slot size and at least two sectors are necessary."
+#endif
+
+#if RTE_BUFFER_SIZE_AT_RUNTIME != 0
+#error "The flash dump requires a circular buffer size defined at compile time (RTE_BUFFER_SIZE_AT_RUNTIME = 0)."
+    // The image size (sizeof(rtedbg_t)) and the slot size check below need the constant buffer size
+#endif
+
+#if defined RTE_COMPILE_TIME_PARAMETER_CHECK
+_Static_assert((sizeof(rte_dump_record_t) + sizeof(rtedbg_t)) <= RTE_DUMP_SLOT_SIZE,
+               "The slot is too small for the g_rtedbg structure.");
+_Static_assert(sizeof(rte_dump_record_t) == RTE_DUMP_FLASH_WORD,
+               "The slot record must fill one flash word.");
+#endif
+
+static uint32_t rte_dump_slot;          // Address of the slot for the next dump (0 - not available)
+static uint32_t rte_dump_sequence;      // Sequence number of the next dump
+
+// Flash word collected by rte_dump_copy()
+typedef struct
+{
+    uint32_t address;       // Flash word address (0 - no data collected)
+    uint32_t data[FLASH_NB_32BITWORD_IN_FLASHWORD];
+} rte_dump_word_t;
+
+
+/***
+ * @brief Wait until the flash bank 2 operation is finished.
+ */
+
+static void rte_dump_wait(void)
+{
+    while ((FLASH->SR2 & (FLASH_SR_QW | FLASH_SR_BSY)) != 0U)
+    {
+        // Wait
+    }
+}
+
+
+/***
+ * @brief Unlock the flash bank 2 and clear the error flags.
+ */
+
+static void rte_dump_unlock(void)
+{
+    if ((FLASH->CR2 & FLASH_CR_LOCK) != 0U)
+    {
+        FLASH->KEYR2 = FLASH_KEY1;
+        FLASH->KEYR2 = FLASH_KEY2;
+    }
+
+    rte_dump_wait();
+    FLASH->CCR2 = RTE_DUMP_CLEAR_ERRORS;
+}
+
+
+/***
+ * @brief Program one flash word (256 bits).
+ *
+ * @param address  Flash word address (32-byte aligned)
+ * @param data     Data to be written
+ */
+
+static void rte_dump_program(const uint32_t address, const uint32_t * const data)
+{
+    volatile uint32_t *dest = (volatile uint32_t *)address;
+
+    FLASH->CR2 |= FLASH_CR_PG;
+    __ISB();
+    __DSB();
+
+    for (uint32_t i = 0U; i < FLASH_NB_32BITWORD_IN_FLASHWORD; i++)
+    {
+        dest[i] = data[i];
+    }
+
+    __ISB();
+    __DSB();
+    rte_dump_wait();
+    FLASH->CR2 &= ~FLASH_CR_PG;
+}
+
+
+/***
+ * @brief Erase the flash sector in the bank 2.
+ *
+ * @param address  Address in the sector
+ */
+
+static void rte_dump_erase_sector(const uint32_t address)
+{
+    uint32_t sector = (address - FLASH_BANK2_BASE) / FLASH_SECTOR_SIZE;
+
+    rte_dump_unlock();
+    FLASH->CR2 = (FLASH->CR2 & ~(FLASH_CR_PSIZE | FLASH_CR_SNB))
+                 | FLASH_CR_SER | FLASH_CR_PSIZE_1 | (sector << FLASH_CR_SNB_Pos);
+    FLASH->CR2 |= FLASH_CR_START;
+    rte_dump_wait();
+    FLASH->CR2 &= ~(FLASH_CR_SER | FLASH_CR_SNB);
+    FLASH->CR2 |= FLASH_CR_LOCK;
+
+#if (__DCACHE_PRESENT == 1U)
+    SCB_InvalidateDCache_by_Addr((void *)address, (int32_t)RTE_DUMP_SECTOR_SIZE);
+#endif
+}
+
+
+/***
+ * @brief Check if the slot is completely erased.
+ *
+ * @param slot  Slot start address
+ *
+ * @return 1 - erased, 0 - not erased
+ */
+
+static uint32_t rte_dump_slot_erased(const uint32_t slot)
+{
+    const uint32_t *word = (const uint32_t *)slot;
+
+    for (uint32_t i = 0U; i < (RTE_DUMP_SLOT_SIZE / 4U); i++)
+    {
+        if (word[i] != RTE_ERASED_STATE)
+        {
+            return 0U;
+        }
+    }
+
+    return 1U;
+}
+
+
+/***
+ * @brief Find the latest valid dump in the flash area.
+ *
+ * @return Address of the slot record or NULL if no dump is available
+ */
+
+const rte_dump_record_t * rte_flash_dump_latest(void)
+{
+    const rte_dump_record_t *latest = NULL;
+
+    for (uint32_t slot = RTE_DUMP_AREA_START; slot < RTE_DUMP_AREA_END; slot += RTE_DUMP_SLOT_SIZE)
+    {
+        const rte_dump_record_t *record = (const rte_dump_record_t *)slot;
+        if ((record->magic == RTE_DUMP_MAGIC) && (record->image_size == sizeof(rtedbg_t)))
+        {
+            if ((latest == NULL) || ((int32_t)(record->sequence - latest->sequence) > 0))
+            {
+                latest = record;
+            }
+        }
+    }
+
+    return latest;
+}
+
+
+/***
+ * @brief Prepare the slot for the next dump. Call the function at startup - before
+ *        the fault handler or the PVD interrupt can call rte_flash_dump_save().
+ *        The slot following the latest dump is used. If it is not erased, the next
+ *        erased slot in the same sector is used or the next sector is erased.
+ *        The sector with the latest dump is never erased.
+ */
+
+void rte_flash_dump_init(void)
+{
+    const rte_dump_record_t *latest = rte_flash_dump_latest();
+    uint32_t slot = RTE_DUMP_AREA_START;
+    rte_dump_sequence = 1U;
+
+    if (latest != NULL)
+    {
+        rte_dump_sequence = latest->sequence + 1U;
+        uint32_t sector = (uint32_t)latest - (((uint32_t)latest - RTE_DUMP_AREA_START) % RTE_DUMP_SECTOR_SIZE);
+        slot = (uint32_t)latest + RTE_DUMP_SLOT_SIZE;
+
+        // Skip the slots with incomplete dumps in the sector with the latest dump
+        while (((slot - sector) < RTE_DUMP_SECTOR_SIZE) && (rte_dump_slot_erased(slot) == 0U))
+        {
+            slot += RTE_DUMP_SLOT_SIZE;
+        }
+
+        if (slot >= RTE_DUMP_AREA_END)
+        {
+            slot = RTE_DUMP_AREA_START;
+        }
+    }
+
+    if (rte_dump_slot_erased(slot) == 0U)
+    {
+        rte_dump_erase_sector(slot);    // The slot is the first one of a sector
+    }
+
+    rte_dump_slot = slot;
+}
+
+
+/***
+ * @brief Program the collected flash word. A flash word without data (all words erased)
+ *        is not programmed.
+ *
+ * @param flash_word  Collected flash word
+ */
+
+static void rte_dump_flush(rte_dump_word_t * const flash_word)
+{
+    if (flash_word->address == 0U)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0U; i < FLASH_NB_32BITWORD_IN_FLASHWORD; i++)
+    {
+        if (flash_word->data[i] != RTE_ERASED_STATE)
+        {
+            rte_dump_program(flash_word->address, flash_word->data);
+            break;
+        }
+    }
+
+    flash_word->address = 0U;
+}
+
+
+/***
+ * @brief Copy a contiguous range of the g_rtedbg words to the dump image. The image word
+ *        offsets are the same as in the g_rtedbg - the words that are not copied stay
+ *        erased. The words are collected in a flash word that is programmed when the copy
+ *        moves on to the next one. Copy the ranges in order of increasing offsets.
+ *
+ * @param flash_word  Collected flash word
+ * @param image       Address of the dump image in the slot
+ * @param offset      Offset of the first word in the g_rtedbg (number of 32-bit words)
+ * @param words       Number of words to copy
+ */
+
+static void rte_dump_copy(rte_dump_word_t * const flash_word, const uint32_t image,
+                          const uint32_t offset, const uint32_t words)
+{
+    const uint32_t *source = (const uint32_t *)&g_rtedbg;
+
+    for (uint32_t n = offset; n < (offset + words); n++)
+    {
+        uint32_t address = image + (n * 4U);
+        uint32_t word_address = address & ~(RTE_DUMP_FLASH_WORD - 1U);
+        if (word_address != flash_word->address)
+        {
+            rte_dump_flush(flash_word);
+            flash_word->address = word_address;
+            for (uint32_t i = 0U; i < FLASH_NB_32BITWORD_IN_FLASHWORD; i++)
+            {
+                flash_word->data[i] = RTE_ERASED_STATE;
+            }
+        }
+
+        flash_word->data[(address - word_address) / 4U] = source[n];
+    }
+}
+
+
+/***
+ * @brief Copy the g_rtedbg header and the newest RTE_DUMP_MAX_WORDS words of the circular
+ *        buffer to the slot prepared by rte_flash_dump_init(). The function is intended
+ *        for the fault handler and the PVD interrupt - it must not be interrupted by the
+ *        data logging functions. Only one dump is saved after each rte_flash_dump_init().
+ */
+
+void rte_flash_dump_save(void)
+{
+    uint32_t slot = rte_dump_slot;
+    if (slot == 0U)
+    {
+        return;         // The slot has not been prepared or has already been used
+    }
+    rte_dump_slot = 0U;
+
+    // The newest data is before the buffer index
+    uint32_t index = g_rtedbg.buf_index;
+    RTE_LIMIT_INDEX(index)
+    uint32_t saved_words = (uint32_t)(RTE_DUMP_MAX_WORDS);
+    if (saved_words > RTE_BUFFER_WORDS)
+    {
+        saved_words = RTE_BUFFER_WORDS;
+    }
+    uint32_t first = (index >= saved_words) ? (index - saved_words)       // Oldest saved word
+                                            : ((index + RTE_BUFFER_WORDS) - saved_words);
+
+    rte_dump_unlock();
+
+    const uint32_t image = slot + sizeof(rte_dump_record_t);
+    rte_dump_word_t flash_word;
+    flash_word.address = 0U;
+
+    rte_dump_copy(&flash_word, image, 0U, RTE_DUMP_HEADER_WORDS);
+    if (first < index)
+    {
+        rte_dump_copy(&flash_word, image, RTE_DUMP_HEADER_WORDS + first, index - first);
+        rte_dump_copy(&flash_word, image, RTE_DUMP_HEADER_WORDS + RTE_BUFFER_WORDS, 4U);
+    }
+    else
+    {
+        // The saved words wrap around the end of the buffer (the 4-word trailer is included)
+        rte_dump_copy(&flash_word, image, RTE_DUMP_HEADER_WORDS, index);
+        rte_dump_copy(&flash_word, image, RTE_DUMP_HEADER_WORDS + first,
+                      (RTE_BUFFER_WORDS + 4U) - first);
+    }
+    rte_dump_flush(&flash_word);
+
+    // The record is written last - it marks the dump as complete
+    rte_dump_record_t record = {
+        RTE_DUMP_MAGIC, rte_dump_sequence, sizeof(rtedbg_t), saved_words, {0U, 0U, 0U, 0U}
+    };
+    rte_dump_program(slot, (const uint32_t *)&record);
+    FLASH->CR2 |= FLASH_CR_LOCK;
+}
+
+/*==== End of file ====*/
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Branko Premzel.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/***
+ * @file   rte_export.h
+ * @author Branko Premzel
+ * @brief  Example of the g_rtedbg structure compression before the export over a slow
+ *         communication link (e.g. a cellular or IoT modem) and the decompression on
+ *         the host. See the description in the rte_export.c.
+ */
+
+#ifndef INC_RTE_EXPORT_H_
+#define INC_RTE_EXPORT_H_
+
+#include <stdint.h>
+
+#define RTE_EXPORT_MAGIC        0x5A455452UL    // Compressed stream marker ("RTEZ")
+#define RTE_EXPORT_CHUNK_SIZE   64U
+    /* Size of the static output buffer (bytes). The compressed data is passed to the
+     * write function in chunks of this size. */
+#define RTE_EXPORT_DICT_SIZE    32U
+    /* Number of the format ID dictionary entries (power of 2) - 4 bytes of static RAM
+     * per entry in the compressor and decompressor. */
+
+/* Function that sends (or stores) a chunk of the compressed data. */
+typedef void (*rte_export_write_t)(const uint8_t *data, uint32_t length);
+
+#if !defined RTE_EXPORT_HOST_TOOL
+uint32_t rte_export_compress(rte_export_write_t write);
+#endif
+uint32_t rte_export_decompress(const uint8_t *data, uint32_t length,
+                               uint32_t *image, uint32_t image_words);
+
+#endif /* INC_RTE_EXPORT_H_ */
+
+/*==== End of file ====*/
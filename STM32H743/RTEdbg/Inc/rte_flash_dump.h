@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Branko Premzel.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/***
+ * @file   rte_flash_dump.h
+ * @author Branko Premzel
+ * @brief  Example of saving the logged data to the internal flash memory of the
+ *         STM32H743 after a fatal exception or before the power supply fails.
+ *
+ * @note Modify the flash area definitions accordingly to the target CPU and project
+ *       requirements. See the description in the Fault_handler.md.
+ */
+
+#ifndef INC_RTE_FLASH_DUMP_H_
+#define INC_RTE_FLASH_DUMP_H_
+
+#include <stdint.h>
+#include "rtedbg.h"
+
+#define RTE_FLASH_DUMP_ENABLED   0
+    /* 1 - rte_flash_dump_init() is called from the main() and the fault handler
+     *     saves the logged data to the flash memory with rte_flash_dump_save().
+     * 0 - The logged data is not saved to the flash memory.
+     */
+
+#define RTE_DUMP_AREA_START      0x081C0000UL
+    /* Start address of the flash area reserved for the data dumps - the last two sectors of
+     * bank 2. The area must not be used for the program code or other data - the flash
+     * memory regions in the linker files (STM32H743ZITX_RAM.ld, EWARM/stm32h743xx_flash.icf
+     * and MDK-ARM) end at this address. Modify them if the area is moved or resized. */
+
+#define RTE_DUMP_SECTORS         2U
+    /* Number of flash sectors in the area (min. 2) - one sector is erased when all of its
+     * slots have been used. The other one still contains the latest dump. */
+
+#define RTE_DUMP_SECTOR_SIZE     0x00020000UL    // Size of a flash sector (128 kB)
+
+#define RTE_DUMP_SLOT_SIZE       0x00004000UL
+    /* Size of a slot - it must hold the slot record and the complete g_rtedbg structure.
+     * The sector size must be divisible by the slot size. */
+
+#define RTE_DUMP_MAX_WORDS       (RTE_BUFFER_SIZE)
+    /* Number of the newest circular buffer words saved by rte_flash_dump_save().
+     * Reduce the value if the complete buffer can not be saved in the available time
+     * (e.g. the hold-up time after the PVD interrupt). The words that are not saved
+     * are left in the erased state and are skipped by the RTEmsg decoder. */
+
+#define RTE_DUMP_MAGIC           0x52544544UL    // Valid slot record marker ("RTED")
+
+
+// Slot record - the first flash word (32 bytes) of a slot. The copy of the g_rtedbg
+// structure follows the record. The record is written last - slots without a valid record
+// contain an incomplete dump (e.g. the power supply failed during the copying).
+typedef struct
+{
+    uint32_t magic;             // RTE_DUMP_MAGIC
+    uint32_t sequence;          // Dump sequence number - the highest number is the latest dump
+    uint32_t image_size;        // Size of the g_rtedbg copy (bytes)
+    uint32_t saved_words;       // Number of saved circular buffer words
+    uint32_t reserved[4];       // Unused - fills the flash word
+} rte_dump_record_t;
+
+void rte_flash_dump_init(void);
+void rte_flash_dump_save(void);
+const rte_dump_record_t * rte_flash_dump_latest(void);
+
+#endif /* INC_RTE_FLASH_DUMP_H_ */
+
+/*==== End of file ====*/
@@ -28,14 +28,6 @@ extern "C" {
 #define RTE_TIMESTAMP_COUNTER_BITS  32U  // Number of timer counter bits available for the timestamp
 
 #if !defined RTE_USE_INLINE_FUNCTIONS
-#if RTE_USE_LONG_TIMESTAMP != 0
-struct _tstamp64
-{
-    uint32_t l;   // Bottom part of the 64-bit timestamp
-    uint32_t h;   // Top part of the 64-bit timestamp
-} t_stamp;
-#endif // RTE_USE_LONG_TIMESTAMP != 0
-
 static uint32_t g_message_counter;
 
 
@@ -47,10 +39,6 @@ static uint32_t g_message_counter;
 __STATIC_FORCEINLINE void rte_init_timestamp_counter(void)
 {
     g_message_counter = 0;
-
-#if RTE_USE_LONG_TIMESTAMP != 0
-    t_stamp.l = t_stamp.h = 0;
-#endif
 }
 #else
 extern uint32_t g_message_counter;
@@ -75,35 +63,6 @@ __STATIC_FORCEINLINE uint32_t rte_get_timestamp(void)
 #endif
 
 
-#if (RTE_USE_LONG_TIMESTAMP != 0) && (!defined RTE_USE_INLINE_FUNCTIONS)
-
-/*********************************************************************************
- * @brief  Writes a message with a long timestamp to the buffer.
- *         The lower bits of the timestamp are included in the message words with the
- *         format ID. Only the upper 32 bits are transmitted in the message's
- *         data part.
- *********************************************************************************/
-
-RTE_OPTIM_SIZE void rte_long_timestamp(void)
-{
-    uint32_t timestamp =
-        (uint32_t)(rte_get_timestamp() << (32U - (RTE_TIMESTAMP_COUNTER_BITS)));
-
-    if (t_stamp.l > timestamp)    // Has the counter rolled over?
-    {
-        t_stamp.h++;
-    }
-
-    t_stamp.l = timestamp;
-    uint64_t timestamp_64 = (uint64_t)timestamp | ((uint64_t)t_stamp.h << 32U);
-    uint32_t long_t_stamp = (uint32_t)(timestamp_64 >>
-                                ((32U - ((uint32_t)(RTE_FMT_ID_BITS))) - 1U + (RTE_TIMESTAMP_SHIFT) +
-                                 (32U - (RTE_TIMESTAMP_COUNTER_BITS))));
-    RTE_MSG1(MSG1_LONG_TIMESTAMP, F_SYSTEM, long_t_stamp);
-}
-
-#endif // (RTE_USE_LONG_TIMESTAMP != 0) && (!defined RTE_USE_INLINE_FUNCTIONS)
-
 #ifdef __cplusplus
 }
 #endif
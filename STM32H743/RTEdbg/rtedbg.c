@@ -48,9 +48,352 @@
 #endif
 
 #if !defined RTE_USE_INLINE_FUNCTIONS
-#define RTE_CFG_MSG0_4 RTE_OPTIM_SPEED  /* Local configuration for __rte_msg0 to __rte_msg4 */
+#define RTE_CFG_MSG0_4 RTE_OPTIM_SPEED RTE_FAST_CODE  /* Local configuration for __rte_msg0 to __rte_msg4 */
 
+#if RTE_BUFFER_SIZE_AT_RUNTIME == 0
 rtedbg_t g_rtedbg RTE_DBG_RAM;      //!< Data structure with circular logging buffer
+#endif
+
+#if RTE_PRIO_BUFFER_SIZE != 0
+rtedbg_prio_t g_rtedbg_prio RTE_PRIO_RAM;   //!< Priority ring for the selected filter groups
+#endif
+
+#if RTE_FMT_ID_FILTER != 0
+uint32_t g_rte_fmt_filter[RTE_FMT_FILTER_WORDS] RTE_FMT_FILTER_RAM;    //!< Per format ID filter (1 = enabled)
+#endif
+
+#if RTE_RATE_LIMIT != 0
+uint32_t g_rte_rate_limited[RTE_FMT_FILTER_WORDS] RTE_FAST_DATA;  //!< Format IDs with a rate limit (1 = limited)
+static rte_rate_limit_t *rte_limit_table RTE_FAST_DATA;           //!< Rate limit table
+static uint32_t rte_limit_count RTE_FAST_DATA;                    //!< Number of rate limit table entries
+#endif
+
+#if RTE_SUPPRESS_REPEATED != 0
+typedef struct
+{
+    uint32_t fmt_id;            //!< Format ID of the last logged message
+    uint32_t words;             //!< Number of its data words
+    uint32_t data[4];           //!< Its data words (unused words are zero)
+    uint32_t count;             //!< Number of suppressed repetitions
+    uint32_t first;             //!< Timestamp of the first suppressed repetition
+    uint32_t last;              //!< Timestamp of the last suppressed repetition
+} rte_repeat_t;
+
+//! Last message of each format ID group (see rte_repeat_slot())
+static rte_repeat_t rte_repeat[RTE_REPEAT_TABLE_SIZE] RTE_FAST_DATA;
+#endif
+
+#if RTE_DCACHE_SNAPSHOT != 0
+volatile uint32_t g_rte_snapshot_request;   //!< Set to non-zero by the host to request a snapshot
+static uint32_t rte_snapshot_index;         //!< Buffer index at the previous snapshot
+#define RTE_SNAPSHOT_ALL  0xFFFFFFFFUL      // Clean the complete structure at the next snapshot
+#endif
+
+#if RTE_RATE_MONITOR != 0
+static struct
+{
+    uint32_t last_index;    // Circular buffer index at the end of the previous window
+    uint32_t shed;          // Filter groups disabled by the rate monitor
+    uint32_t quiet;         // Number of consecutive windows below half of the budget
+} rte_rate;
+#endif
+
+#if RTE_USE_LONG_TIMESTAMP != 0
+rte_tstamp64_t g_rte_tstamp RTE_FAST_DATA;  //!< 64-bit extension of the timestamp counter
+
+
+/***
+ * @brief Reset the 64-bit timestamp. The next rte_long_timestamp_check() call logs
+ *        the long timestamp unconditionally.
+ */
+
+__STATIC_FORCEINLINE void rte_reset_long_timestamp(void)
+{
+    g_rte_tstamp.l = 0U;
+    g_rte_tstamp.h = 0U;
+    g_rte_tstamp.half = 0xFFFFFFFFU;
+    g_rte_tstamp.last_msg = 0x80000000U;  // Log the long timestamp before the first message
+}
+#endif // RTE_USE_LONG_TIMESTAMP != 0
+
+
+/********************************************************************************
+ * @brief Set the buffer to the erased state (0xFFFFFFFF). The buffer is erased in
+ *        segments of RTE_ERASE_SEGMENT_SIZE words if this parameter is not zero and
+ *        RTE_ERASE_SEGMENT_HOOK() is called after each segment - e.g. to refresh the
+ *        watchdog while a large buffer in external SDRAM or PSRAM is erased.
+ *
+ * @param buffer  Start address of the buffer
+ * @param words   Number of 32-bit words to erase
+ ********************************************************************************/
+
+static void rte_erase_buffer(uint32_t * const buffer, const uint32_t words)
+{
+    uint32_t index = 0U;
+    while (index < words)
+    {
+        uint32_t segment = words - index;
+#if RTE_ERASE_SEGMENT_SIZE != 0
+        if (segment > (uint32_t)(RTE_ERASE_SEGMENT_SIZE))
+        {
+            segment = (uint32_t)(RTE_ERASE_SEGMENT_SIZE);
+        }
+#endif
+
+#if defined RTE_USE_MEMSET
+        memset(&buffer[index], RTE_ERASED_STATE & 0xFFu, segment * sizeof(uint32_t));
+#else
+        for (uint32_t i = index; i < (index + segment); i++)
+        {
+            *((volatile uint32_t *)(&buffer[i])) = RTE_ERASED_STATE;  //lint !e929
+                // volatile used to prevent compiler from using the memset() function
+                // memset() is slow in many embedded system library implementations (setting bytes instead of words)
+        }
+#endif // defined RTE_USE_MEMSET
+
+        index += segment;
+        RTE_ERASE_SEGMENT_HOOK();
+    }
+}
+
+
+#if RTE_RESUME_CHECK != 0
+/********************************************************************************
+ * @brief Check the circular buffer index and repair the message that was being
+ *        written when the system was reset. The FMT word of a subpacket is written
+ *        after its data words. DATA words (bit 0 = 0) and not yet written words directly
+ *        before the buffer index therefore belong to an unfinished message and are erased
+ *        - at most one subpacket (5 words) is checked. The check stops at the first
+ *        FMT word. An index outside of the range possible after a message has been
+ *        logged is set to zero.
+ *
+ * @note  Only the unfinished subpacket at the end of the buffer is detected. The following
+ *        words are kept and may be decoded as a damaged or an old message:
+ *        - an unfinished message that was interrupted by a message of a higher priority
+ *          task or interrupt - the interrupting message was completed after it, so the
+ *          check stops at its FMT word,
+ *        - reserved words that were never written if their old content (from the previous
+ *          pass through the circular buffer) ends with an FMT word,
+ *        - the preceding subpackets of an unfinished message longer than one subpacket.
+ *
+ * @return Number of erased words
+ ********************************************************************************/
+
+static uint32_t rte_repair_tail(void)
+{
+    uint32_t index = g_rtedbg.buf_index;
+    uint32_t erased = 0U;
+
+    if (index > (RTE_BUFFER_WORDS + 4U))
+    {
+        if (index >= (RTE_BUFFER_WORDS + ((uint32_t)(RTE_MAX_SUBPACKETS) * 5U)))
+        {
+            g_rtedbg.buf_index = 0U;    // Invalid index - continue logging at the buffer start
+        }
+        return 0U;  // The last subpacket of a long message has wrapped around - not checked
+    }
+
+    while ((index > 0U) && (erased < 5U))
+    {
+        uint32_t word = g_rtedbg.buffer[index - 1U];
+        if (((word & 1U) != 0U) && (word != RTE_ERASED_STATE))
+        {
+            break;  // FMT word - the last subpacket is complete
+        }
+
+        index--;
+        g_rtedbg.buffer[index] = RTE_ERASED_STATE;
+        erased++;
+    }
+
+    return erased;
+}
+
+
+/********************************************************************************
+ * @brief Calculate the check word of the header values that are changed only by
+ *        rte_init() and rte_timestamp_frequency() - rte_cfg, timestamp_frequency,
+ *        buffer_size and index_mask. The buf_index, filter and filter_copy values are
+ *        changed during logging and by the host software and are not checked.
+ *
+ * @param p_rtedbg  Data logging structure (RTE_MAIN_RTEDBG or an additional instance)
+ * @return Header check word
+ ********************************************************************************/
+
+static uint32_t rte_header_check(rtedbg_inst_t * const p_rtedbg)
+{
+    uint32_t check = 0x52544548UL;      // Seed "RTEH" - erased or cleared header is invalid
+    check = ((check << 7U) | (check >> 25U)) ^ RTE_FIELD(p_rtedbg, rte_cfg);
+    check = ((check << 7U) | (check >> 25U)) ^ RTE_FIELD(p_rtedbg, timestamp_frequency);
+    check = ((check << 7U) | (check >> 25U)) ^ RTE_FIELD(p_rtedbg, buffer_size);
+#if RTE_BUFFER_SIZE_AT_RUNTIME != 0
+    check = ((check << 7U) | (check >> 25U)) ^ RTE_FIELD(p_rtedbg, index_mask);
+#endif
+    return check;
+}
+
+#define RTE_HEADER_IS_VALID(ptr)      (RTE_FIELD(ptr, header_check) == rte_header_check(ptr))
+#define RTE_UPDATE_HEADER_CHECK(ptr)  { RTE_FIELD(ptr, header_check) = rte_header_check(ptr); }
+#else
+#define RTE_HEADER_IS_VALID(ptr)      1
+#define RTE_UPDATE_HEADER_CHECK(ptr)
+#endif // RTE_RESUME_CHECK != 0
+
+
+#if (RTE_INSTANCES != 0) || (RTE_PRIO_BUFFER_SIZE != 0)
+/********************************************************************************
+ * @brief Initialize the instance header. The buffer is erased only if the instance
+ *        has not been initialized yet or if a restart of logging is requested.
+ *
+ * @param inst         Logging instance
+ * @param buffer_size  Size of the circular buffer (number of 32-bit words)
+ * @param config_id    Configuration word of the instance
+ * @param init_mode    See the rte_init() description
+ ********************************************************************************/
+
+static void rte_instance_setup(rtedbg_inst_t * const inst, const uint32_t buffer_size,
+                               const uint32_t config_id, const uint32_t init_mode)
+{
+    if ((config_id & RTE_SINGLE_SHOT_LOGGING_IS_ACTIVE) != 0U)
+    {
+        inst->buf_index = 0U;
+    }
+
+    if ((inst->rte_cfg != config_id) || (inst->buffer_size != (buffer_size + 4U))
+        || !RTE_HEADER_IS_VALID(inst) || (init_mode >= RTE_RESTART_LOGGING))
+    {
+        inst->filter = 0U;
+        RTE_DATA_MEMORY_BARRIER();
+        rte_erase_buffer(&inst->buffer[0], buffer_size + 4U);
+        inst->buf_index = 0U;
+    }
+
+    inst->rte_cfg = config_id;
+    inst->buffer_size = buffer_size + 4U;
+#if RTE_BUFFER_SIZE_AT_RUNTIME != 0
+    inst->index_mask = 0U;              // Not used - the index wraps at the end of the buffer
+#endif
+    inst->timestamp_frequency = RTE_GET_TSTAMP_FREQUENCY();
+    RTE_UPDATE_HEADER_CHECK(inst)
+}
+#endif // (RTE_INSTANCES != 0) || (RTE_PRIO_BUFFER_SIZE != 0)
+
+
+#if RTE_PRIO_BUFFER_SIZE != 0
+/* Long timestamps are logged to both rings - the main ring must be decodable without the priority ring */
+#define RTE_LONG_TSTAMP_FMT_ID  RTE_PACK(F_SYSTEM, MSG1_LONG_TIMESTAMP, 1U)
+
+/********************************************************************************
+ * @brief Initialize the priority ring. It is always used in the post-mortem mode.
+ *        In the mirror mode the ring contents are kept after the restart of logging
+ *        - it contains the last messages logged before the reset or power loss.
+ *        The ring is erased only if the configuration has changed.
+ *
+ * @param config_id  Configuration word of the g_rtedbg structure
+ * @param init_mode  See the rte_init() description
+ ********************************************************************************/
+
+static void rte_prio_init(const uint32_t config_id, const uint32_t init_mode)
+{
+#if RTE_PRIO_MIRROR != 0
+    (void)init_mode;
+    rte_instance_setup(RTE_PRIO_RING, RTE_PRIO_BUFFER_SIZE,
+                       config_id & 0x7FFFFFFEUL, RTE_CONTINUE_LOGGING);
+#else
+    rte_instance_setup(RTE_PRIO_RING, RTE_PRIO_BUFFER_SIZE,
+                       config_id & 0x7FFFFFFEUL, init_mode);
+#endif
+    // The messages are routed to the ring by the g_rtedbg logging functions. The long
+    // timestamps (F_SYSTEM) are always logged to it.
+    RTE_PRIO_RING->filter = (uint32_t)(RTE_PRIO_FILTER_MASK) | 0x80000000UL;
+    RTE_PRIO_RING->filter_copy = 0U;
+}
+#endif // RTE_PRIO_BUFFER_SIZE != 0
+
+
+/********************************************************************************
+ * @brief Set the message filter of a data logging structure - see rte_set_filter().
+ *
+ * @param p_rtedbg  Data logging structure (RTE_MAIN_RTEDBG or an additional instance)
+ * @param filter    New message filter value
+ ********************************************************************************/
+
+__STATIC_FORCEINLINE void rte_write_filter(rtedbg_inst_t * const p_rtedbg, const uint32_t filter)
+{
+    uint32_t new_value = filter;
+#if RTE_FILTER_OFF_ENABLED != 0
+    RTE_DATA_MEMORY_BARRIER();          // Ensure visibility of changes across all CPU cores.
+    if (RTE_FIELD(p_rtedbg, filter) == 0U)  // Are message filters completely disabled?
+    {
+        if (new_value != RTE_FORCE_ENABLE_ALL_FILTERS) // Enable even if completely disabled?
+        {
+            new_value = 0U;
+        }
+    }
+#endif // RTE_FILTER_OFF_ENABLED != 0
+
+#if RTE_BUFFER_SIZE_AT_RUNTIME != 0
+    if (RTE_MAIN_BUFFER(p_rtedbg) && (g_rtedbg.buffer_size == 0U))
+    {
+        new_value = 0U;                 // The buffer is too small - see rte_init()
+    }
+#endif
+
+    if (new_value != 0U)
+    {
+        // Filter #0 cannot be disabled unless all other filters are also disabled.
+        new_value |= ~(uint32_t)RTE_FORCE_ENABLE_ALL_FILTERS;
+        RTE_FIELD(p_rtedbg, filter_copy) = new_value;   // Store the last non-zero filter value
+    }
+
+    RTE_FIELD(p_rtedbg, filter) = new_value;
+    RTE_DATA_MEMORY_BARRIER();          // Ensure visibility of changes across all CPU cores.
+}
+
+
+#if RTE_INSTANCES != 0
+/********************************************************************************
+ * @brief Initialize an additional data logging instance - see RTE_INSTANCE_STORAGE().
+ *        Call the function after rte_init() since the timestamp timer is
+ *        initialized there. The messages logged to the instances have the same
+ *        timestamps as the g_rtedbg messages. The long timestamps are logged to
+ *        the g_rtedbg only - decode the instances together with the g_rtedbg.
+ *
+ * @param p_rtedbg              Logging instance (e.g. RTE_INSTANCE(capture))
+ * @param buffer_size           Size of the circular buffer (number of 32-bit words)
+ *                              - must match the size used in RTE_INSTANCE_STORAGE()
+ * @param initial_filter_value  Initial message filter value
+ * @param init_mode             See the rte_init() description
+ ********************************************************************************/
+
+RTE_OPTIM_SIZE void rte_init_i(rtedbg_inst_t * const p_rtedbg, const uint32_t buffer_size,
+                               const uint32_t initial_filter_value, const uint32_t init_mode)
+{
+    uint32_t config_id = (uint32_t)RTE_CONFIG_ID & 0x7FFFFFFEUL;           //lint !e9053
+#if RTE_SINGLE_SHOT_ENABLED != 0
+    config_id |= init_mode & RTE_SINGLE_SHOT_LOGGING_IS_ACTIVE;
+#endif
+
+    rte_instance_setup(p_rtedbg, buffer_size, config_id, init_mode);
+    // Non-zero value - rte_write_filter() must not keep a disabled filter of the erased buffer
+    p_rtedbg->filter = RTE_FORCE_ENABLE_ALL_FILTERS;
+    rte_write_filter(p_rtedbg, initial_filter_value);
+}
+
+
+/********************************************************************************
+ * @brief Set the message filter of an additional data logging instance. See the
+ *        rte_set_filter() description.
+ *
+ * @param p_rtedbg  Logging instance
+ * @param filter    New message filter value
+ ********************************************************************************/
+
+RTE_OPTIM_SIZE void rte_set_filter_i(rtedbg_inst_t * const p_rtedbg, const uint32_t filter)
+{
+    rte_write_filter(p_rtedbg, filter);
+}
+#endif // RTE_INSTANCES != 0
 
 
 /********************************************************************************
@@ -100,6 +443,62 @@ RTE_OPTIM_SIZE void rte_init(const uint32_t initial_filter_value, const uint32_t
     }
 #endif // RTE_SINGLE_SHOT_ENABLED != 0
 
+#if RTE_BUFFER_SIZE_AT_RUNTIME != 0
+    // The circular buffer size is the largest power of 2 that fits into the available space
+    uint32_t available = (uint32_t)(RTE_GET_BUFFER_SIZE());
+    uint32_t index_mask = 0U;
+    if (available >= (RTE_MIN_RUNTIME_BUFFER + 4U))
+    {
+        index_mask = 0x80000000U;
+        while (index_mask > (available - 4U))
+        {
+            index_mask >>= 1U;
+        }
+        index_mask--;
+    }
+
+    if (index_mask < (RTE_MIN_RUNTIME_BUFFER - 1U))
+    {
+        // The space is too small for the largest message - message logging stays disabled
+        g_rtedbg.filter = 0U;
+        g_rtedbg.filter_copy = 0U;
+        g_rtedbg.rte_cfg = 0U;
+        g_rtedbg.buffer_size = 0U;
+        g_rtedbg.index_mask = 0U;
+        RTE_DATA_MEMORY_BARRIER();  // Make sure all CPU cores see the change.
+        return;
+    }
+
+    if (g_rtedbg.index_mask != index_mask)
+    {
+        g_rtedbg.rte_cfg = 0U;      // Force the initialization
+        g_rtedbg.index_mask = index_mask;
+    }
+#endif
+
+#if RTE_RESUME_CHECK != 0
+    uint32_t resumed_index = g_rtedbg.buf_index;
+    uint32_t erased_words = 0xFFFFFFFFU;    // Logging not resumed
+
+    if ((g_rtedbg.buffer_size != (RTE_BUFFER_WORDS + 4U)) || !RTE_HEADER_IS_VALID(RTE_MAIN_RTEDBG))
+    {
+        g_rtedbg.rte_cfg = 0U;      // Invalid header - force the initialization
+    }
+#endif
+
+#if RTE_FMT_ID_FILTER != 0
+    /* Enable all format IDs after a logging (re)start or configuration change. The host
+     * software can disable individual ones at run time. Its settings are kept if logging
+     * continues after a reset (RTE_CONTINUE_LOGGING). */
+    if ((g_rtedbg.rte_cfg != config_id) || (init_mode != RTE_CONTINUE_LOGGING))
+    {
+        for (uint32_t i = 0U; i < RTE_FMT_FILTER_WORDS; i++)
+        {
+            g_rte_fmt_filter[i] = 0xFFFFFFFFU;
+        }
+    }
+#endif
+
     // If g_rtedbg has not yet been initialized, clear the header and circular buffer.
     if ((g_rtedbg.rte_cfg != config_id) || (init_mode >= RTE_RESTART_LOGGING))
     {
@@ -112,19 +511,7 @@ RTE_OPTIM_SIZE void rte_init(const uint32_t initial_filter_value, const uint32_t
          * appear as normal data and enables the rtemsg data decoding software to detect that
          * part of the buffer has been reserved but not yet written to - e.g. because the task
          * logging data has been interrupted for a long time by higher priority tasks or services. */
-#if defined RTE_USE_MEMSET
-        memset(&g_rtedbg.buffer, RTE_ERASED_STATE & 0xFFu, sizeof(g_rtedbg.buffer));
-#else
-        int32_t count = (int32_t)((sizeof(g_rtedbg.buffer) / sizeof(uint32_t)) - 1U);
-        do
-        {
-            *((volatile uint32_t *)(&g_rtedbg.buffer[(unsigned)count])) = RTE_ERASED_STATE;  //lint !e929
-                // volatile used to prevent compiler from using the memset() function
-                // memset() is slow in many embedded system library implementations (setting bytes instead of words)
-            count--;
-        }
-        while (count >= 0);
-#endif // defined RTE_USE_MEMSET
+        rte_erase_buffer(&g_rtedbg.buffer[0], RTE_BUFFER_WORDS + 4U);
 
 #if (RTE_FILTER_OFF_ENABLED != 0) && (RTE_MSG_FILTERING_ENABLED != 0)
         g_rtedbg.filter = initial_filter_value;
@@ -134,13 +521,49 @@ RTE_OPTIM_SIZE void rte_init(const uint32_t initial_filter_value, const uint32_t
 #endif
         g_rtedbg.buf_index = 0U;
     }
+#if RTE_RESUME_CHECK != 0
+    else if ((config_id & RTE_SINGLE_SHOT_LOGGING_IS_ACTIVE) == 0U)
+    {
+        erased_words = rte_repair_tail();
+    }
+    else
+    {
+        // Single shot logging restarts at the beginning of the buffer
+    }
+#endif
+
+#if RTE_PRIO_BUFFER_SIZE != 0
+    rte_prio_init(config_id, init_mode);
+#endif
+
+#if RTE_SUPPRESS_REPEATED != 0
+    for (uint32_t i = 0U; i < RTE_REPEAT_TABLE_SIZE; i++)
+    {
+        rte_repeat[i].fmt_id = 0xFFFFFFFFUL;    // No message logged yet
+        rte_repeat[i].count = 0U;
+    }
+#endif
+
+#if RTE_DCACHE_SNAPSHOT != 0
+    rte_snapshot_index = RTE_SNAPSHOT_ALL;
+#endif
+
+#if RTE_RATE_MONITOR != 0
+    rte_rate.last_index = g_rtedbg.buf_index;
+    rte_rate.shed = 0U;
+    rte_rate.quiet = 0U;
+#endif
 
     g_rtedbg.rte_cfg = config_id;
-    g_rtedbg.buffer_size = (uint32_t)(RTE_BUFFER_SIZE) + 4U;
+    g_rtedbg.buffer_size = RTE_BUFFER_WORDS + 4U;
 
     // Set the timestamp frequency and initialize the timestamp timer
     g_rtedbg.timestamp_frequency = RTE_GET_TSTAMP_FREQUENCY();
+    RTE_UPDATE_HEADER_CHECK(RTE_MAIN_RTEDBG)
     rte_init_timestamp_counter();
+#if RTE_USE_LONG_TIMESTAMP != 0
+    rte_reset_long_timestamp();
+#endif
 
 #if RTE_FILTER_OFF_ENABLED != 0
     rte_set_filter(initial_filter_value);
@@ -149,16 +572,230 @@ RTE_OPTIM_SIZE void rte_init(const uint32_t initial_filter_value, const uint32_t
     g_rtedbg.filter = initial_filter_value;
 #endif
 #endif
+
+#if RTE_RESUME_CHECK != 0
+    if (erased_words != 0xFFFFFFFFU)
+    {
+        // Mark the reset boundary in the post-mortem log
+        RTE_MSG2(MSG2_LOG_RESUMED, F_SYSTEM, resumed_index, erased_words)
+    }
+#endif
 }
 #else
 #define RTE_CFG_MSG0_4 __STATIC_FORCEINLINE
 #endif  // !defined RTE_USE_INLINE_FUNCTIONS
 
+#if RTE_USE_LONG_TIMESTAMP != 0
+/* Number of bits the 64-bit timestamp (counter value aligned to bit 31) must be shifted
+ * right to get the long timestamp value. The short timestamp logged with each message
+ * covers one period of 2^RTE_LONG_TSTAMP_SHIFT. */
+#define RTE_LONG_TSTAMP_SHIFT                                                 \
+    (((32U - ((uint32_t)(RTE_FMT_ID_BITS))) - 1U) + (RTE_TIMESTAMP_SHIFT) + \
+     (32U - (RTE_TIMESTAMP_COUNTER_BITS)))
+#endif
+
+#if (RTE_LONG_TIMESTAMP_IN_MSG != 0) && ((RTE_USE_LONG_TIMESTAMP == 0) || (RTE_DELAYED_TSTAMP_READ != 0))
+#error "RTE_LONG_TIMESTAMP_IN_MSG requires RTE_USE_LONG_TIMESTAMP = 1 and RTE_DELAYED_TSTAMP_READ = 0."
+    /* The long timestamp must be logged before the buffer space for the message is reserved.
+     * With RTE_DELAYED_TSTAMP_READ = 1 the timestamp is read after the reservation. */
+#endif
+
+#if RTE_LONG_TIMESTAMP_IN_MSG != 0
+// Timestamp counter value aligned to bit 31 - converted to the FMT word timestamp by RTE_MSG_TSTAMP_CHECK()
+#define RTE_GET_MSG_TIMESTAMP() \
+    ((uint32_t)(rte_get_timestamp() << (32U - (RTE_TIMESTAMP_COUNTER_BITS))))
+
+// FMT word timestamp of the counter value aligned to bit 31
+#define RTE_TSTAMP_FIELD(timestamp) \
+    (((timestamp) >> ((32U - (RTE_TIMESTAMP_COUNTER_BITS)) + ((RTE_TIMESTAMP_SHIFT) - 1U))) & RTE_TIMESTAMP_MASK)
+
+/********************************************************************************
+ * @brief Check the timestamp of a message that will be logged. Log the long timestamp
+ *        before the message if the time since the previous logged message exceeds
+ *        half of the short timestamp period (the short timestamp would become
+ *        ambiguous) or if the 64-bit timestamp was not extended for half of the timer
+ *        counter period. Call the function only after the message has passed the
+ *        filter checks and before the buffer space is reserved - discarded messages
+ *        must not update the time of the last message.
+ *
+ * @note  A gap between messages longer than the timer counter period can not be
+ *        detected. Call rte_long_timestamp_check() at least once per timer counter
+ *        period if such gaps are possible.
+ *
+ * @param timestamp  Timestamp read with RTE_GET_MSG_TIMESTAMP()
+ *
+ * @return Timestamp value for the FMT word.
+ ********************************************************************************/
+
+__STATIC_FORCEINLINE uint32_t rte_msg_timestamp(uint32_t timestamp)
+{
+    if (((timestamp - g_rte_tstamp.last_msg) >= (1UL << (RTE_LONG_TSTAMP_SHIFT - 1U))) ||
+        ((timestamp - g_rte_tstamp.l) >= 0x80000000UL))
+    {
+        rte_long_timestamp();
+        timestamp = RTE_GET_MSG_TIMESTAMP();    // The message must not be older than the long timestamp
+    }
+
+    g_rte_tstamp.last_msg = timestamp;
+    return RTE_TSTAMP_FIELD(timestamp);
+}
+
+// The gap check and long timestamp injection are done for the g_rtedbg messages only
+#define RTE_MSG_TSTAMP_CHECK(ptr, timestamp) \
+    timestamp = RTE_MAIN_BUFFER(ptr) ? rte_msg_timestamp(timestamp) : RTE_TSTAMP_FIELD(timestamp);
+#else
+#define RTE_GET_MSG_TIMESTAMP()  ((rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK)
+#define RTE_MSG_TSTAMP_CHECK(ptr, timestamp)
+#endif // RTE_LONG_TIMESTAMP_IN_MSG != 0
+
+
+#if RTE_SUPPRESS_REPEATED != 0
+/* Packed format ID of the repetition record - must not be compared with the last message */
+#define RTE_REPEATED_FMT_ID  RTE_PACK(F_SYSTEM, MSG4_MSG_REPEATED, 4U)
+
+// Table slot of a message - the packed format IDs of consecutive messages differ by one
+#define RTE_REPEAT_SLOT(fmt_id, words)  (((fmt_id) + (words)) & ((RTE_REPEAT_TABLE_SIZE) - 1U))
+
+/* Timestamp of a repetition in the units of the message timestamp field (decoder units) */
+#if RTE_LONG_TIMESTAMP_IN_MSG != 0
+#define RTE_REPEAT_TSTAMP(timestamp)  (RTE_TSTAMP_FIELD(timestamp) >> 1U)
+#else
+#define RTE_REPEAT_TSTAMP(timestamp)  ((timestamp) >> 1U)
+#endif
+
+/********************************************************************************
+ * @brief Log the number of suppressed repetitions of a message (if any).
+ *
+ * @param fmt_code  Format ID code of the message (format ID the decoder uses)
+ * @param count     Number of suppressed repetitions
+ * @param first     Timestamp of the first suppressed repetition
+ * @param last      Timestamp of the last suppressed repetition
+ ********************************************************************************/
+
+static void rte_log_repeated(const uint32_t fmt_code, const uint32_t count,
+                             const uint32_t first, const uint32_t last)
+{
+    if (count != 0U)
+    {
+        RTE_MSG4(MSG4_MSG_REPEATED, F_SYSTEM, fmt_code, count, first, last)
+    }
+}
+
+
+/********************************************************************************
+ * @brief Check if the message is identical to the last one logged with the same
+ *        format ID by the __rte_msg0() ... __rte_msg4(). An identical message is
+ *        only counted. The last messages of up to RTE_REPEAT_TABLE_SIZE format IDs
+ *        are kept so that interleaved messages of different sources are suppressed
+ *        too. The number of repetitions is logged before the next different message
+ *        with the same format ID (or table slot).
+ *
+ * @param timestamp       Timestamp of the message (already read by the caller) or NULL.
+ *                        It is read again after the repetition record is logged so that
+ *                        the message is not older than the record in the buffer.
+ * @param fmt_id          Packed format ID of the message
+ * @param words           Number of data words (0 to 4)
+ * @param data1 ... data4 Message data (unused words must be zero)
+ *
+ * @return 1 - repeated message (discard it), 0 - log the message
+ ********************************************************************************/
+
+static RTE_FAST_CODE uint32_t rte_msg_repeated(uint32_t * const timestamp,
+                                               const uint32_t fmt_id, const uint32_t words,
+                                               const uint32_t data1, const uint32_t data2,
+                                               const uint32_t data3, const uint32_t data4)
+{
+    if (fmt_id == RTE_REPEATED_FMT_ID)
+    {
+        return 0U;
+    }
+
+    uint32_t now = (timestamp != NULL) ? *timestamp : RTE_GET_MSG_TIMESTAMP();
+    now = RTE_REPEAT_TSTAMP(now);
+    rte_repeat_t *p_repeat = &rte_repeat[RTE_REPEAT_SLOT(fmt_id, words)];
+    RTE_ENTER_CRITICAL()
+
+    if ((fmt_id == p_repeat->fmt_id) && (words == p_repeat->words)
+        && (data1 == p_repeat->data[0U]) && (data2 == p_repeat->data[1U])
+        && (data3 == p_repeat->data[2U]) && (data4 == p_repeat->data[3U]))
+    {
+        if (p_repeat->count == 0U)
+        {
+            p_repeat->first = now;
+        }
+        p_repeat->count++;
+        p_repeat->last = now;
+        RTE_EXIT_CRITICAL()
+        return 1U;
+    }
+
+    uint32_t fmt_code = RTE_FMT_CODE(p_repeat->fmt_id, p_repeat->words);
+    uint32_t count = p_repeat->count;
+    uint32_t first = p_repeat->first;
+    uint32_t last = p_repeat->last;
+    p_repeat->fmt_id = fmt_id;
+    p_repeat->words = words;
+    p_repeat->data[0U] = data1;
+    p_repeat->data[1U] = data2;
+    p_repeat->data[2U] = data3;
+    p_repeat->data[3U] = data4;
+    p_repeat->count = 0U;
+    RTE_EXIT_CRITICAL()
+
+    if (count != 0U)
+    {
+        rte_log_repeated(fmt_code, count, first, last);
+
+        if (timestamp != NULL)
+        {
+            *timestamp = RTE_GET_MSG_TIMESTAMP();   // The message follows the record
+        }
+    }
+    return 0U;
+}
+
+
+/********************************************************************************
+ * @brief Log the number of suppressed repetitions of all messages now. Call
+ *        it periodically, before the data transfer to the host and before the
+ *        message logging is stopped with rte_set_filter(0U) so that the
+ *        repetitions of the last messages are not missing in the decoded data.
+ ********************************************************************************/
+
+RTE_OPTIM_SIZE void rte_flush_repeated(void)
+{
+    for (uint32_t i = 0U; i < RTE_REPEAT_TABLE_SIZE; i++)
+    {
+        RTE_ENTER_CRITICAL()
+        uint32_t fmt_code = RTE_FMT_CODE(rte_repeat[i].fmt_id, rte_repeat[i].words);
+        uint32_t count = rte_repeat[i].count;
+        uint32_t first = rte_repeat[i].first;
+        uint32_t last = rte_repeat[i].last;
+        rte_repeat[i].fmt_id = 0xFFFFFFFFUL;
+        rte_repeat[i].count = 0U;
+        RTE_EXIT_CRITICAL()
+
+        rte_log_repeated(fmt_code, count, first, last);
+    }
+}
+
+#if RTE_DELAYED_TSTAMP_READ != 1
+#define RTE_MSG_REPEATED(fmt_id, words, data1, data2, data3, data4) \
+    rte_msg_repeated(&timestamp, fmt_id, words, data1, data2, data3, data4)
+#else
+#define RTE_MSG_REPEATED(fmt_id, words, data1, data2, data3, data4) \
+    rte_msg_repeated(NULL, fmt_id, words, data1, data2, data3, data4)
+#endif
+#else
+#define RTE_MSG_REPEATED(fmt_id, words, data1, data2, data3, data4)  0U
+#endif // RTE_SUPPRESS_REPEATED != 0
+
 
 /********************************************************************************
  * @brief Write only format ID and timestamp to circular buffer.
  *
- * @param fmt_id  Format ID number
+ * @param p_rtedbg  Data logging structure - RTE_MAIN_RTEDBG (g_rtedbg) or an additional instance
+ * @param fmt_id    Format ID number
  *        The format ID combines a format ID with the filter number.
  *        The lower bits contain extended data in the case of the EXT_MSG.. macro.
  *        See the macro RTE_PACK() to see how the two or three values are packed
@@ -168,56 +805,92 @@ RTE_OPTIM_SIZE void rte_init(const uint32_t initial_filter_value, const uint32_t
 
 #if RTE_MINIMIZED_CODE_SIZE == 0
 
-RTE_CFG_MSG0_4 void __rte_msg0(const uint32_t fmt_id)
+__STATIC_FORCEINLINE void rte_msg0(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id)
 {
-    rtedbg_t *p_rtedbg = &g_rtedbg;
-
 #if RTE_DELAYED_TSTAMP_READ != 1
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
 
-    if (RTE_MESSAGE_DISABLED(p_rtedbg->filter, fmt_id, 0U))
+    if (RTE_MESSAGE_DISABLED(RTE_FIELD(p_rtedbg, filter), fmt_id, 0U)
+        || (RTE_MAIN_BUFFER(p_rtedbg) && RTE_FMT_ID_DISABLED(fmt_id, 0U)))
     {
         return;     // Discard the message if not enabled
     }
 
+    if (RTE_MAIN_BUFFER(p_rtedbg) && (RTE_MSG_REPEATED(fmt_id, 0U, 0U, 0U, 0U, 0U) != 0U))
+    {
+        return;     // Identical to the last message - counted only
+    }
+
+    RTE_MSG_TSTAMP_CHECK(p_rtedbg, timestamp)
+
+#if RTE_PRIO_BUFFER_SIZE != 0
+    if (RTE_MAIN_BUFFER(p_rtedbg) && RTE_PRIO_MSG(fmt_id, 0U))
+    {
+        __rte_msg0_i(RTE_PRIO_RING, fmt_id);
+#if RTE_PRIO_MIRROR == 0
+        return;
+#endif
+    }
+#endif
+
     uint32_t buf_index;
     RTE_RESERVE_SPACE(p_rtedbg, buf_index, 1U);                             //lint !e717
 
 #if RTE_DELAYED_TSTAMP_READ != 0
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
 
-    p_rtedbg->buffer[buf_index] = timestamp | 1U | (fmt_id << (32U - (uint32_t)(RTE_FMT_ID_BITS)));
+    RTE_BUF(p_rtedbg)[buf_index] = timestamp | 1U | (fmt_id << (32U - (uint32_t)(RTE_FMT_ID_BITS)));
 }
 
 
 /********************************************************************************
  * @brief  Log a message containing one 32-bit word + timestamp/format ID
  *
- * @param  fmt_id  Format ID number - see the description of __rte_msg0().
- * @param  data1   Any 32-bit data
+ * @param  p_rtedbg  Data logging structure - see the description of rte_msg0().
+ * @param  fmt_id    Format ID number - see the description of rte_msg0().
+ * @param  data1     Any 32-bit data
  ********************************************************************************/
 
-RTE_CFG_MSG0_4 void __rte_msg1(const uint32_t fmt_id, const rte_any32_t data1)
+__STATIC_FORCEINLINE void rte_msg1(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id, const rte_any32_t data1)
 {
-    rtedbg_t *p_rtedbg = &g_rtedbg;
-
 #if RTE_DELAYED_TSTAMP_READ != 1
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
 
-    if (RTE_MESSAGE_DISABLED(p_rtedbg->filter, fmt_id, 1U))
+    if (RTE_MESSAGE_DISABLED(RTE_FIELD(p_rtedbg, filter), fmt_id, 1U)
+        || (RTE_MAIN_BUFFER(p_rtedbg) && RTE_FMT_ID_DISABLED(fmt_id, 1U)))
     {
         return;
     }
 
+    if (RTE_MAIN_BUFFER(p_rtedbg) && (RTE_MSG_REPEATED(fmt_id, 1U, RTE_PARAM(data1), 0U, 0U, 0U) != 0U))
+    {
+        return;     // Identical to the last message - counted only
+    }
+
+    RTE_MSG_TSTAMP_CHECK(p_rtedbg, timestamp)
+
+#if RTE_PRIO_BUFFER_SIZE != 0
+    if (RTE_MAIN_BUFFER(p_rtedbg) && RTE_PRIO_MSG(fmt_id, 1U))
+    {
+        __rte_msg1_i(RTE_PRIO_RING, fmt_id, data1);
+#if RTE_PRIO_MIRROR == 0
+        if (fmt_id != RTE_LONG_TSTAMP_FMT_ID)
+        {
+            return;
+        }
+#endif
+    }
+#endif
+
     uint32_t buf_index;
     RTE_RESERVE_SPACE(p_rtedbg, buf_index, 2U);                             //lint !e717
 
     rte_pack_data_t data;                                                   //lint !e9018
     data.w32.bits31 = fmt_id;
-    uint32_t *data_packet = &g_rtedbg.buffer[buf_index];
+    uint32_t *data_packet = &RTE_BUF(p_rtedbg)[buf_index];
 
     data.w32.data = RTE_PARAM(data1);
     data.w64 <<= 1U;
@@ -225,7 +898,7 @@ RTE_CFG_MSG0_4 void __rte_msg1(const uint32_t fmt_id, const rte_any32_t data1)
     data_packet++;
 
 #if RTE_DELAYED_TSTAMP_READ != 0
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
     *data_packet = timestamp | 1U | (data.w32.bits31 << (32U - (uint32_t)(RTE_FMT_ID_BITS)));
 }
@@ -234,22 +907,40 @@ RTE_CFG_MSG0_4 void __rte_msg1(const uint32_t fmt_id, const rte_any32_t data1)
 /********************************************************************************
  * @brief  Log a message containing two 32-bit words + timestamp/format ID
  *
- * @param  fmt_id        Format ID number - see the description of __rte_msg0().
+ * @param  p_rtedbg      Data logging structure - see the description of rte_msg0().
+ * @param  fmt_id        Format ID number - see the description of rte_msg0().
  * @param  data1, data2  Any 32-bit data
  ********************************************************************************/
 
-RTE_CFG_MSG0_4 void __rte_msg2(const uint32_t fmt_id, const rte_any32_t data1, const rte_any32_t data2)
+__STATIC_FORCEINLINE void rte_msg2(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id,
+                                   const rte_any32_t data1, const rte_any32_t data2)
 {
-    rtedbg_t *p_rtedbg = &g_rtedbg;
-
 #if RTE_DELAYED_TSTAMP_READ != 1
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
 
-    if (RTE_MESSAGE_DISABLED(p_rtedbg->filter, fmt_id, 2U))
+    if (RTE_MESSAGE_DISABLED(RTE_FIELD(p_rtedbg, filter), fmt_id, 2U)
+        || (RTE_MAIN_BUFFER(p_rtedbg) && RTE_FMT_ID_DISABLED(fmt_id, 2U)))
+    {
+        return;
+    }
+
+    if (RTE_MAIN_BUFFER(p_rtedbg) && (RTE_MSG_REPEATED(fmt_id, 2U, RTE_PARAM(data1), RTE_PARAM(data2), 0U, 0U) != 0U))
     {
+        return;     // Identical to the last message - counted only
+    }
+
+    RTE_MSG_TSTAMP_CHECK(p_rtedbg, timestamp)
+
+#if RTE_PRIO_BUFFER_SIZE != 0
+    if (RTE_MAIN_BUFFER(p_rtedbg) && RTE_PRIO_MSG(fmt_id, 2U))
+    {
+        __rte_msg2_i(RTE_PRIO_RING, fmt_id, data1, data2);
+#if RTE_PRIO_MIRROR == 0
         return;
+#endif
     }
+#endif
 
     uint32_t buf_index;
     RTE_RESERVE_SPACE(p_rtedbg, buf_index, 3U);                             //lint !e717
@@ -259,7 +950,7 @@ RTE_CFG_MSG0_4 void __rte_msg2(const uint32_t fmt_id, const rte_any32_t data1, c
 
     data.w32.data = RTE_PARAM(data1);
     data.w64 <<= 1U;
-    uint32_t *data_packet = &g_rtedbg.buffer[buf_index];
+    uint32_t *data_packet = &RTE_BUF(p_rtedbg)[buf_index];
     *data_packet = data.w32.data;
     data_packet++;
 
@@ -269,7 +960,7 @@ RTE_CFG_MSG0_4 void __rte_msg2(const uint32_t fmt_id, const rte_any32_t data1, c
     data_packet++;
 
 #if RTE_DELAYED_TSTAMP_READ != 0
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
     // The FMT word with timestamp is written as the last value after other values are already in the buffer
     *data_packet = timestamp | 1U | (data.w32.bits31 << (32U - (uint32_t)(RTE_FMT_ID_BITS)));
@@ -279,23 +970,40 @@ RTE_CFG_MSG0_4 void __rte_msg2(const uint32_t fmt_id, const rte_any32_t data1, c
 /********************************************************************************
  * @brief  Log a message containing three 32-bit words + timestamp/format ID
  *
- * @param  fmt_id           Format ID number - see the description of __rte_msg0().
+ * @param  p_rtedbg         Data logging structure - see the description of rte_msg0().
+ * @param  fmt_id           Format ID number - see the description of rte_msg0().
  * @param  data1 ... data3  Any 32-bit data
  ********************************************************************************/
 
-RTE_CFG_MSG0_4 void __rte_msg3(const uint32_t fmt_id, const rte_any32_t data1,
-                                const rte_any32_t data2, const rte_any32_t data3)
+__STATIC_FORCEINLINE void rte_msg3(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id, const rte_any32_t data1,
+                                   const rte_any32_t data2, const rte_any32_t data3)
 {
-    rtedbg_t *p_rtedbg = &g_rtedbg;
-
 #if RTE_DELAYED_TSTAMP_READ != 1
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
 
-    if (RTE_MESSAGE_DISABLED(p_rtedbg->filter, fmt_id, 3U))
+    if (RTE_MESSAGE_DISABLED(RTE_FIELD(p_rtedbg, filter), fmt_id, 3U)
+        || (RTE_MAIN_BUFFER(p_rtedbg) && RTE_FMT_ID_DISABLED(fmt_id, 3U)))
+    {
+        return;
+    }
+
+    if (RTE_MAIN_BUFFER(p_rtedbg) && (RTE_MSG_REPEATED(fmt_id, 3U, RTE_PARAM(data1), RTE_PARAM(data2), RTE_PARAM(data3), 0U) != 0U))
+    {
+        return;     // Identical to the last message - counted only
+    }
+
+    RTE_MSG_TSTAMP_CHECK(p_rtedbg, timestamp)
+
+#if RTE_PRIO_BUFFER_SIZE != 0
+    if (RTE_MAIN_BUFFER(p_rtedbg) && RTE_PRIO_MSG(fmt_id, 3U))
     {
+        __rte_msg3_i(RTE_PRIO_RING, fmt_id, data1, data2, data3);
+#if RTE_PRIO_MIRROR == 0
         return;
+#endif
     }
+#endif
 
     uint32_t buf_index;
     RTE_RESERVE_SPACE(p_rtedbg, buf_index, 4U);                             //lint !e717
@@ -305,7 +1013,7 @@ RTE_CFG_MSG0_4 void __rte_msg3(const uint32_t fmt_id, const rte_any32_t data1,
 
     data.w32.data = RTE_PARAM(data1);
     data.w64 <<= 1U;    // The top bit of all data words are packed to the FMT word
-    uint32_t *data_packet = &g_rtedbg.buffer[buf_index];
+    uint32_t *data_packet = &RTE_BUF(p_rtedbg)[buf_index];
     *data_packet = data.w32.data;
     data_packet++;
 
@@ -320,7 +1028,7 @@ RTE_CFG_MSG0_4 void __rte_msg3(const uint32_t fmt_id, const rte_any32_t data1,
     data_packet++;
 
 #if RTE_DELAYED_TSTAMP_READ != 0
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
 
     // The FMT word with timestamp is written as the last value after other values are already in the buffer
@@ -331,59 +1039,145 @@ RTE_CFG_MSG0_4 void __rte_msg3(const uint32_t fmt_id, const rte_any32_t data1,
 /********************************************************************************
  * @brief  Log a message containing four 32-bit words + timestamp/format ID
  *
- * @param  fmt_id           Format ID number - see the description of __rte_msg0().
+ * @param  p_rtedbg         Data logging structure - see the description of rte_msg0().
+ * @param  fmt_id           Format ID number - see the description of rte_msg0().
  * @param  data1 ... data4  Any 32-bit data
  ********************************************************************************/
 
-RTE_CFG_MSG0_4 void __rte_msg4(const uint32_t fmt_id, const rte_any32_t data1, const rte_any32_t data2,
-                                const rte_any32_t data3, const rte_any32_t data4)
+__STATIC_FORCEINLINE void rte_msg4(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id, const rte_any32_t data1,
+                                   const rte_any32_t data2, const rte_any32_t data3, const rte_any32_t data4)
 {
-    rtedbg_t *p_rtedbg = &g_rtedbg;
-
 #if RTE_DELAYED_TSTAMP_READ != 1
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
 
-    if (RTE_MESSAGE_DISABLED(p_rtedbg->filter, fmt_id, 4U))
+    if (RTE_MESSAGE_DISABLED(RTE_FIELD(p_rtedbg, filter), fmt_id, 4U)
+        || (RTE_MAIN_BUFFER(p_rtedbg) && RTE_FMT_ID_DISABLED(fmt_id, 4U)))
     {
         return;
     }
 
+    if (RTE_MAIN_BUFFER(p_rtedbg) && (RTE_MSG_REPEATED(fmt_id, 4U, RTE_PARAM(data1), RTE_PARAM(data2),
+                                                     RTE_PARAM(data3), RTE_PARAM(data4)) != 0U))
+    {
+        return;     // Identical to the last message - counted only
+    }
+
+    RTE_MSG_TSTAMP_CHECK(p_rtedbg, timestamp)
+
+#if RTE_PRIO_BUFFER_SIZE != 0
+    if (RTE_MAIN_BUFFER(p_rtedbg) && RTE_PRIO_MSG(fmt_id, 4U))
+    {
+        __rte_msg4_i(RTE_PRIO_RING, fmt_id, data1, data2, data3, data4);
+#if RTE_PRIO_MIRROR == 0
+        return;
+#endif
+    }
+#endif
+
     uint32_t buf_index;
     RTE_RESERVE_SPACE(p_rtedbg, buf_index, 5U);                             //lint !e717
 
     rte_pack_data_t data;                                                   //lint !e9018
     data.w32.bits31 = fmt_id;
 
-    // Save data to the buffer
-    data.w32.data = RTE_PARAM(data1);
-    data.w64 <<= 1U;
-    uint32_t *data_packet = &g_rtedbg.buffer[buf_index];
-    *data_packet = data.w32.data;
-    data_packet++;
+    // Save data to the buffer
+    data.w32.data = RTE_PARAM(data1);
+    data.w64 <<= 1U;
+    uint32_t *data_packet = &RTE_BUF(p_rtedbg)[buf_index];
+    *data_packet = data.w32.data;
+    data_packet++;
+
+    data.w32.data = RTE_PARAM(data2);
+    data.w64 <<= 1U;
+    *data_packet = data.w32.data;
+    data_packet++;
+
+    data.w32.data = RTE_PARAM(data3);
+    data.w64 <<= 1U;
+    *data_packet = data.w32.data;
+    data_packet++;
+
+    data.w32.data = RTE_PARAM(data4);
+    data.w64 <<= 1U;
+    *data_packet = data.w32.data;
+    data_packet++;
+
+#if RTE_DELAYED_TSTAMP_READ != 0
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
+#endif
+
+    // The FMT word with timestamp is written as the last value after other values are already in the buffer
+    *data_packet = timestamp | 1U | (data.w32.bits31 << (32U - (uint32_t)(RTE_FMT_ID_BITS)));
+}
+
+/***
+ * @brief The __rte_msg0() ... __rte_msg4() functions log to the g_rtedbg and the
+ *        __rte_msg0_i() ... __rte_msg4_i() functions to an additional instance or the
+ *        priority ring. Both use the same code. The comparisons of the pointer with
+ *        RTE_MAIN_RTEDBG are resolved at compile time in the g_rtedbg functions - they
+ *        are as fast as if they were written for the g_rtedbg only.
+ */
+
+RTE_CFG_MSG0_4 void __rte_msg0(const uint32_t fmt_id)
+{
+    rte_msg0(RTE_MAIN_RTEDBG, fmt_id);
+}
+
+RTE_CFG_MSG0_4 void __rte_msg1(const uint32_t fmt_id, const rte_any32_t data1)
+{
+    rte_msg1(RTE_MAIN_RTEDBG, fmt_id, data1);
+}
+
+RTE_CFG_MSG0_4 void __rte_msg2(const uint32_t fmt_id, const rte_any32_t data1, const rte_any32_t data2)
+{
+    rte_msg2(RTE_MAIN_RTEDBG, fmt_id, data1, data2);
+}
+
+RTE_CFG_MSG0_4 void __rte_msg3(const uint32_t fmt_id, const rte_any32_t data1,
+                                const rte_any32_t data2, const rte_any32_t data3)
+{
+    rte_msg3(RTE_MAIN_RTEDBG, fmt_id, data1, data2, data3);
+}
+
+RTE_CFG_MSG0_4 void __rte_msg4(const uint32_t fmt_id, const rte_any32_t data1, const rte_any32_t data2,
+                                const rte_any32_t data3, const rte_any32_t data4)
+{
+    rte_msg4(RTE_MAIN_RTEDBG, fmt_id, data1, data2, data3, data4);
+}
 
-    data.w32.data = RTE_PARAM(data2);
-    data.w64 <<= 1U;
-    *data_packet = data.w32.data;
-    data_packet++;
+#if ((RTE_INSTANCES != 0) || (RTE_PRIO_BUFFER_SIZE != 0)) && !defined RTE_USE_INLINE_FUNCTIONS
+RTE_OPTIM_SPEED RTE_FAST_CODE void __rte_msg0_i(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id)
+{
+    rte_msg0(p_rtedbg, fmt_id);
+}
 
-    data.w32.data = RTE_PARAM(data3);
-    data.w64 <<= 1U;
-    *data_packet = data.w32.data;
-    data_packet++;
+RTE_OPTIM_SPEED RTE_FAST_CODE void __rte_msg1_i(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id,
+                                                const rte_any32_t data1)
+{
+    rte_msg1(p_rtedbg, fmt_id, data1);
+}
 
-    data.w32.data = RTE_PARAM(data4);
-    data.w64 <<= 1U;
-    *data_packet = data.w32.data;
-    data_packet++;
+RTE_OPTIM_SPEED RTE_FAST_CODE void __rte_msg2_i(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id,
+                                                const rte_any32_t data1, const rte_any32_t data2)
+{
+    rte_msg2(p_rtedbg, fmt_id, data1, data2);
+}
 
-#if RTE_DELAYED_TSTAMP_READ != 0
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
-#endif
+RTE_OPTIM_SPEED RTE_FAST_CODE void __rte_msg3_i(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id,
+                                                const rte_any32_t data1, const rte_any32_t data2,
+                                                const rte_any32_t data3)
+{
+    rte_msg3(p_rtedbg, fmt_id, data1, data2, data3);
+}
 
-    // The FMT word with timestamp is written as the last value after other values are already in the buffer
-    *data_packet = timestamp | 1U | (data.w32.bits31 << (32U - (uint32_t)(RTE_FMT_ID_BITS)));
+RTE_OPTIM_SPEED RTE_FAST_CODE void __rte_msg4_i(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id,
+                                                const rte_any32_t data1, const rte_any32_t data2,
+                                                const rte_any32_t data3, const rte_any32_t data4)
+{
+    rte_msg4(p_rtedbg, fmt_id, data1, data2, data3, data4);
 }
+#endif
 
 #else // RTE_MINIMIZED_CODE_SIZE == 1
 
@@ -396,18 +1190,18 @@ RTE_CFG_MSG0_4 void __rte_msg4(const uint32_t fmt_id, const rte_any32_t data1, c
  *        non-minimized version of the functions can be shorter than the minimized one.
  */
 
-RTE_OPTIM_SIZE void __rte_msg0(const uint32_t fmt_id)
+RTE_OPTIM_SIZE RTE_FAST_CODE void __rte_msg0(const uint32_t fmt_id)
 {
     __rte_msgn(fmt_id, NULL, 0U);
 }
 
-RTE_OPTIM_SIZE void __rte_msg1(const uint32_t fmt_id, const rte_any32_t data1)
+RTE_OPTIM_SIZE RTE_FAST_CODE void __rte_msg1(const uint32_t fmt_id, const rte_any32_t data1)
 {
     uint32_t data = RTE_PARAM(data1);
     __rte_msgn(fmt_id, &data, sizeof(uint32_t));
 }
 
-RTE_OPTIM_SIZE void __rte_msg2(const uint32_t fmt_id, const rte_any32_t data1, const rte_any32_t data2)
+RTE_OPTIM_SIZE RTE_FAST_CODE void __rte_msg2(const uint32_t fmt_id, const rte_any32_t data1, const rte_any32_t data2)
 {
     uint32_t data[2];
     data[0U] = RTE_PARAM(data1);
@@ -415,8 +1209,8 @@ RTE_OPTIM_SIZE void __rte_msg2(const uint32_t fmt_id, const rte_any32_t data1, c
     __rte_msgn(fmt_id, &data[0U], sizeof(data));
 }
 
-RTE_OPTIM_SIZE void __rte_msg3(const uint32_t fmt_id, const rte_any32_t data1,
-                               const rte_any32_t data2, const rte_any32_t data3)
+RTE_OPTIM_SIZE RTE_FAST_CODE void __rte_msg3(const uint32_t fmt_id, const rte_any32_t data1,
+                                             const rte_any32_t data2, const rte_any32_t data3)
 {
     uint32_t data[3];
     data[0U] = RTE_PARAM(data1);
@@ -425,8 +1219,8 @@ RTE_OPTIM_SIZE void __rte_msg3(const uint32_t fmt_id, const rte_any32_t data1,
     __rte_msgn(fmt_id, &data[0U], sizeof(data));
 }
 
-RTE_OPTIM_SIZE void __rte_msg4(const uint32_t fmt_id, const rte_any32_t data1, const rte_any32_t data2,
-                               const rte_any32_t data3, const rte_any32_t data4)
+RTE_OPTIM_SIZE RTE_FAST_CODE void __rte_msg4(const uint32_t fmt_id, const rte_any32_t data1, const rte_any32_t data2,
+                                             const rte_any32_t data3, const rte_any32_t data4)
 {
     uint32_t data[4];
     data[0U] = RTE_PARAM(data1);
@@ -442,7 +1236,10 @@ RTE_OPTIM_SIZE void __rte_msg4(const uint32_t fmt_id, const rte_any32_t data1, c
 #if !defined RTE_USE_INLINE_FUNCTIONS
 /********************************************************************************
  * @brief Log a message defined by address and size + timestamp/format ID.
+ *        The __rte_msgn() logs to the g_rtedbg and the __rte_msgn_i() to an additional
+ *        instance or the priority ring.
  *
+ * @param p_rtedbg     Data logging structure - see the description of rte_msg0().
  * @param fmt_id       Format ID number - see the description of __rte_msg0().
  * @param address      Start address of data
  * @param data_length  Data length (bytes)
@@ -473,8 +1270,8 @@ RTE_OPTIM_SIZE void __rte_msg4(const uint32_t fmt_id, const rte_any32_t data1, c
  * region accessible by the task calling this function.
  ********************************************************************************/
 
-RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
-                                volatile const void *const address, const uint32_t data_length)
+__STATIC_FORCEINLINE void rte_msgn(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id,
+                                   volatile const void *const address, const uint32_t data_length)
 {
 #if RTE_DISCARD_MSGS_WITH_UNALIGNED_ADDRESS == 1
     if ((uint32_t)address & 3U)
@@ -483,7 +1280,6 @@ RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
     }
 #endif
 
-    rtedbg_t *p_rtedbg = &g_rtedbg;
     volatile const uint32_t *addr_w = (volatile const uint32_t *)address;    //lint !e925 !e9079 !e9087
 #if RTE_HANDLE_UNALIGNED_MEMORY_ACCESS == 1
     volatile const uint8_t *addr_b = (volatile const uint8_t *)address;       //lint !e925 !e9079 !e9087
@@ -491,10 +1287,12 @@ RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
     uint32_t length = data_length;
 
 #if RTE_DELAYED_TSTAMP_READ != 1
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
 
-    if (RTE_MESSAGE_DISABLED(p_rtedbg->filter, fmt_id, (RTE_MINIMIZED_CODE_SIZE != 0) ? 0U : 4U))   //lint !e948 !e944
+    if (RTE_MESSAGE_DISABLED(RTE_FIELD(p_rtedbg, filter), fmt_id, (RTE_MINIMIZED_CODE_SIZE != 0) ? 0U : 4U)     //lint !e948 !e944
+        || (RTE_MAIN_BUFFER(p_rtedbg)
+            && RTE_FMT_ID_DISABLED(fmt_id, (RTE_MINIMIZED_CODE_SIZE != 0) ? 0U : 4U)))              //lint !e948 !e944
     {
         return;     // Discard the message if not enabled
     }
@@ -508,6 +1306,18 @@ RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
 #endif
     }
 
+    RTE_MSG_TSTAMP_CHECK(p_rtedbg, timestamp)
+
+#if RTE_PRIO_BUFFER_SIZE != 0
+    if (RTE_MAIN_BUFFER(p_rtedbg) && RTE_PRIO_MSG(fmt_id, 4U))
+    {
+        __rte_msgn_i(RTE_PRIO_RING, fmt_id, address, length);
+#if RTE_PRIO_MIRROR == 0
+        return;
+#endif
+    }
+#endif
+
     // Calculate the space required to copy the message to the circular buffer
     uint32_t no_words = ((length + 3U) / 4U) + ((length + 15U) / 16U);  // Add one FMT word for every four 32-bit DATA words
     if (no_words == 0U)
@@ -519,7 +1329,7 @@ RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
     RTE_RESERVE_SPACE(p_rtedbg, buf_index, no_words);                       //lint !e717
 
 #if RTE_DELAYED_TSTAMP_READ != 0
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
 
 #if RTE_MINIMIZED_CODE_SIZE != 0
@@ -545,7 +1355,7 @@ RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
 #endif
 
             // Store data in the reserved space in the circular buffer
-            uint32_t *data_packet = &g_rtedbg.buffer[buf_index];
+            uint32_t *data_packet = &RTE_BUF(p_rtedbg)[buf_index];
             uint32_t words_this_packet = (no_words > 5U) ? 5U : no_words;
 
             // Process full words in this packet
@@ -571,7 +1381,7 @@ RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
 #endif
 
             buf_index += 5U;
-            RTE_LIMIT_INDEX(buf_index)
+            RTE_LIMIT_BUF_INDEX(p_rtedbg, buf_index)
             no_words -= words_this_packet;
         }
         while ((int32_t)no_words > 0);
@@ -589,7 +1399,7 @@ RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
 #endif
 
             // Store data in the reserved space in the circular buffer
-            uint32_t *data_packet = &g_rtedbg.buffer[buf_index];
+            uint32_t *data_packet = &RTE_BUF(p_rtedbg)[buf_index];
             switch (no_words)
             {
                 default:
@@ -633,7 +1443,7 @@ RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
             }
 
             buf_index += 5U;
-            RTE_LIMIT_INDEX(buf_index)
+            RTE_LIMIT_BUF_INDEX(p_rtedbg, buf_index)
             no_words -= 5U;
         }
         while ((int32_t)no_words > 0);
@@ -647,7 +1457,7 @@ RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
         data.w32.bits31 = 0xF0U;    // Extended data mask
 
         // Store data in the reserved space in the circular buffer
-        uint32_t *data_packet = &g_rtedbg.buffer[buf_index];
+        uint32_t *data_packet = &RTE_BUF(p_rtedbg)[buf_index];
         uint32_t words_this_packet = (no_words > 5U) ? 5U : no_words;
 
         // Process full words in this packet
@@ -678,7 +1488,7 @@ RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
                       (((data.w32.bits31 & 0x0FU) | (fmt_id & (data.w32.bits31 >> 4U)))
                        << (32U - (uint32_t)(RTE_FMT_ID_BITS)));
         buf_index += 5U;
-        RTE_LIMIT_INDEX(buf_index)
+        RTE_LIMIT_BUF_INDEX(p_rtedbg, buf_index)
         no_words -= 5U;
     }
     while ((int32_t)no_words > 0);
@@ -688,6 +1498,21 @@ RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
 }
 
 
+RTE_OPTIM_LARGE RTE_FAST_CODE void __rte_msgn(const uint32_t fmt_id,
+                                              volatile const void *const address, const uint32_t data_length)
+{
+    rte_msgn(RTE_MAIN_RTEDBG, fmt_id, address, data_length);
+}
+
+#if (RTE_INSTANCES != 0) || (RTE_PRIO_BUFFER_SIZE != 0)
+RTE_OPTIM_LARGE RTE_FAST_CODE void __rte_msgn_i(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id,
+                                                volatile const void *const address, const uint32_t data_length)
+{
+    rte_msgn(p_rtedbg, fmt_id, address, data_length);
+}
+#endif
+
+
 /********************************************************************************
  * @brief Log a message defined by address and size + timestamp/format ID.
  *        The maximum message length is either 255 bytes or (RTE_MAX_SUBPACKETS * 16) - 1
@@ -704,17 +1529,17 @@ RTE_OPTIM_LARGE void __rte_msgn(const uint32_t fmt_id,
  *        null terminated. The data is read as bytes from the source address.
  ********************************************************************************/
 
-RTE_OPTIM_LARGE void __rte_msgx(const uint32_t fmt_id,
-                                volatile const void *const address, const uint32_t data_length)
+RTE_OPTIM_LARGE RTE_FAST_CODE void __rte_msgx(const uint32_t fmt_id,
+                                              volatile const void *const address, const uint32_t data_length)
 {
-    rtedbg_t *p_rtedbg = &g_rtedbg;
+    rtedbg_inst_t * const p_rtedbg = RTE_MAIN_RTEDBG;
     uint32_t length = data_length;
 
 #if RTE_DELAYED_TSTAMP_READ != 1
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
 
-    if (RTE_MESSAGE_DISABLED(p_rtedbg->filter, fmt_id, 4U))
+    if (RTE_MESSAGE_DISABLED(RTE_FIELD(p_rtedbg, filter), fmt_id, 4U) || RTE_FMT_ID_DISABLED(fmt_id, 4U))
     {
         return;
     }
@@ -729,12 +1554,14 @@ RTE_OPTIM_LARGE void __rte_msgx(const uint32_t fmt_id,
 #endif
     }
 
+    RTE_MSG_TSTAMP_CHECK(p_rtedbg, timestamp)
+
     uint32_t no_words = 2U + (length / 4U) + (length / 16U);
     uint32_t buf_index;
     RTE_RESERVE_SPACE(p_rtedbg, buf_index, no_words);                       //lint !e717
 
 #if RTE_DELAYED_TSTAMP_READ != 0
-    uint32_t timestamp = (rte_get_timestamp() >> ((RTE_TIMESTAMP_SHIFT) - 1U)) & RTE_TIMESTAMP_MASK;
+    uint32_t timestamp = RTE_GET_MSG_TIMESTAMP();
 #endif
 
     timestamp |= (fmt_id << (32U - ((uint32_t)(RTE_FMT_ID_BITS) - 4U))) | 1U;
@@ -802,7 +1629,7 @@ RTE_OPTIM_LARGE void __rte_msgx(const uint32_t fmt_id,
  * @param address  String start address
  ********************************************************************************/
 
-RTE_OPTIM_SIZE void __rte_string(const uint32_t fmt_id, const char * const address)
+RTE_OPTIM_SIZE RTE_FAST_CODE void __rte_string(const uint32_t fmt_id, const char * const address)
 {
     __rte_stringn(fmt_id, address, RTE_MAX_MSG_SIZE);
 }
@@ -819,8 +1646,8 @@ RTE_OPTIM_SIZE void __rte_string(const uint32_t fmt_id, const char * const addre
  * @param max_length  Maximum message length to be stored in the circular buffer
  ********************************************************************************/
 
-RTE_OPTIM_SPEED void __rte_stringn(const uint32_t fmt_id,
-                                   const char * const address, const uint32_t max_length)
+RTE_OPTIM_SPEED RTE_FAST_CODE void __rte_stringn(const uint32_t fmt_id,
+                                                 const char * const address, const uint32_t max_length)
 {
     uint32_t length = max_length;
     if (RTE_MAX_MSG_SIZE < length)
@@ -855,27 +1682,7 @@ RTE_OPTIM_SPEED void __rte_stringn(const uint32_t fmt_id,
 
 RTE_OPTIM_SIZE void rte_set_filter(const uint32_t filter)
 {
-    uint32_t new_value = filter;
-#if RTE_FILTER_OFF_ENABLED != 0
-    RTE_DATA_MEMORY_BARRIER();          // Ensure visibility of changes across all CPU cores.
-    if (g_rtedbg.filter == 0U)          // Are message filters completely disabled?
-    {
-        if (new_value != RTE_FORCE_ENABLE_ALL_FILTERS) // Enable even if completely disabled?
-        {
-            new_value = 0U;
-        }
-    }
-#endif // RTE_FILTER_OFF_ENABLED != 0
-
-    if (new_value != 0U)
-    {
-        // Filter #0 cannot be disabled unless all other filters are also disabled.
-        new_value |= ~(uint32_t)RTE_FORCE_ENABLE_ALL_FILTERS;
-        g_rtedbg.filter_copy = new_value;   // Store the last non-zero filter value
-    }
-
-    g_rtedbg.filter = new_value;
-    RTE_DATA_MEMORY_BARRIER();          // Ensure visibility of changes across all CPU cores.
+    rte_write_filter(RTE_MAIN_RTEDBG, filter);
 }
 
 
@@ -905,6 +1712,288 @@ RTE_OPTIM_SIZE uint32_t rte_get_filter(void)
 }
 
 
+#if RTE_RATE_MONITOR != 0
+/********************************************************************************
+ * @brief Change the filter groups for the rate monitor. The filter is read and written
+ *        with interrupts disabled, so that a value written meanwhile by rte_set_filter()
+ *        or RTE_STOP_MESSAGE_LOGGING() is not overwritten with an old one. Stopped
+ *        message logging (filter = 0) is not enabled again.
+ *
+ * @param clear_mask  Filter groups to disable
+ * @param set_mask    Filter groups to enable
+ *
+ * @return New filter value or 0 if the message logging is stopped.
+ ********************************************************************************/
+
+static uint32_t rte_rate_change_filter(const uint32_t clear_mask, const uint32_t set_mask)
+{
+    RTE_ENTER_CRITICAL()
+    uint32_t filter = g_rtedbg.filter;
+    if (filter != 0U)
+    {
+        filter = (filter & ~clear_mask) | set_mask;
+        g_rtedbg.filter = filter;
+        RTE_DATA_MEMORY_BARRIER();      // Ensure visibility of changes across all CPU cores.
+    }
+    RTE_EXIT_CRITICAL()
+    return filter;
+}
+
+
+/********************************************************************************
+ * @brief Adaptive load shedding. Each call ends one monitoring window - call the
+ *        function periodically, e.g. every 10 ms from a timer interrupt.
+ *        If more than RTE_RATE_BUDGET words were written to the circular buffer in the
+ *        window, the enabled filter group with the lowest priority (highest filter
+ *        number) from RTE_RATE_SHED_MASK is disabled. After RTE_RATE_RESTORE_WINDOWS
+ *        consecutive windows below half of the budget, one of the disabled groups
+ *        (highest priority first) is re-enabled if it is also enabled in the filter_copy.
+ *        Each change is logged with the MSG2_LOAD_SHEDDING message.
+ *
+ * @note  The function is not reentrant. Call it from one place in the program only.
+ *        Filter #0 is never disabled.
+ ********************************************************************************/
+
+RTE_OPTIM_SIZE void rte_rate_monitor(void)
+{
+    uint32_t index = g_rtedbg.buf_index;
+    uint32_t words = index - rte_rate.last_index;
+    if (index < rte_rate.last_index)
+    {
+        words += RTE_BUFFER_WORDS;              // The index has wrapped around
+    }
+    rte_rate.last_index = index;
+
+    uint32_t filter = g_rtedbg.filter;
+    if (filter == 0U)
+    {
+        return;     // Message logging is stopped
+    }
+
+    if (words >= ((uint32_t)(RTE_RATE_BUDGET) / 2U))
+    {
+        rte_rate.quiet = 0U;
+    }
+    else
+    {
+        rte_rate.quiet++;
+    }
+
+    if (words > (uint32_t)(RTE_RATE_BUDGET))
+    {
+        uint32_t enabled = filter & (uint32_t)(RTE_RATE_SHED_MASK) & 0x7FFFFFFFU;
+        if (enabled != 0U)
+        {
+            uint32_t group = enabled & (0U - enabled);  // Lowest priority enabled group
+            rte_rate.shed |= group;
+            filter = rte_rate_change_filter(group, 0U);
+            if (filter != 0U)
+            {
+                RTE_MSG2(MSG2_LOAD_SHEDDING, F_SYSTEM, filter, words)
+            }
+        }
+    }
+    else if ((rte_rate.shed != 0U) && (rte_rate.quiet >= (uint32_t)(RTE_RATE_RESTORE_WINDOWS)))
+    {
+        rte_rate.quiet = 0U;
+        uint32_t group = 0x80000000U;
+        while ((rte_rate.shed & group) == 0U)
+        {
+            group >>= 1U;                   // Find the highest priority disabled group
+        }
+
+        rte_rate.shed &= ~group;
+#if RTE_FIRMWARE_MAY_SET_FILTER != 0
+        filter = rte_rate_change_filter(0U, group & g_rtedbg.filter_copy);
+#else
+        filter = rte_rate_change_filter(0U, group);
+#endif
+        if (filter != 0U)
+        {
+            RTE_MSG2(MSG2_LOAD_SHEDDING, F_SYSTEM, filter, words)
+        }
+    }
+    else
+    {
+        // The number of logged words is within the budget
+    }
+}
+#endif // RTE_RATE_MONITOR != 0
+
+
+#if RTE_RATE_LIMIT != 0
+/********************************************************************************
+ * @brief Register the rate limit table. Each entry limits the number of messages with
+ *        one format ID to max_count per rte_rate_limit_refill() call period.
+ *        Example:
+ *          static rte_rate_limit_t rate_limits[] =
+ *          {
+ *              { MSG1_ADC_OVERRUN, 100U, 0U, 0U },  // Max. 100/s if refilled every second
+ *          };
+ *          rte_rate_limit_init(rate_limits, sizeof(rate_limits) / sizeof(rate_limits[0]));
+ *
+ * @param table  Rate limit table (must stay valid while logging is active)
+ * @param count  Number of table entries
+ *
+ * @note  Messages with extended data (EXT_MSG..) have one format ID code for each
+ *        extended data value. Only the code from the table is rate limited.
+ ********************************************************************************/
+
+RTE_OPTIM_SIZE void rte_rate_limit_init(rte_rate_limit_t * const table, const uint32_t count)
+{
+    for (uint32_t i = 0U; i < RTE_FMT_FILTER_WORDS; i++)
+    {
+        g_rte_rate_limited[i] = 0U;
+    }
+
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        uint32_t code = RTE_FMT_CODE(table[i].fmt_id, 0U);
+        table[i].tokens = table[i].max_count;
+        table[i].suppressed = 0U;
+        g_rte_rate_limited[code >> 5U] |= 0x80000000U >> (code & 31U);
+    }
+
+    rte_limit_table = table;
+    rte_limit_count = count;
+    RTE_DATA_MEMORY_BARRIER();      // Ensure visibility of changes across all CPU cores.
+}
+
+
+/********************************************************************************
+ * @brief Take one token from the rate limit bucket of the message. Called by the
+ *        logging functions for the format IDs with a rate limit only.
+ *
+ * @param fmt_code  Format ID code of the message
+ *
+ * @return 1 - the message must be discarded, 0 - the message can be logged
+ ********************************************************************************/
+
+RTE_OPTIM_SIZE RTE_FAST_CODE uint32_t rte_rate_limit_exceeded(const uint32_t fmt_code)
+{
+    uint32_t exceeded = 0U;
+
+    for (uint32_t i = 0U; i < rte_limit_count; i++)
+    {
+        rte_rate_limit_t *limit = &rte_limit_table[i];
+        if (RTE_FMT_CODE((uint32_t)limit->fmt_id, 0U) == fmt_code)
+        {
+            RTE_ENTER_CRITICAL()
+            if (limit->tokens != 0U)
+            {
+                limit->tokens--;
+            }
+            else
+            {
+                if (limit->suppressed < 0xFFFFU)
+                {
+                    limit->suppressed++;
+                }
+                exceeded = 1U;
+            }
+            RTE_EXIT_CRITICAL()
+            break;
+        }
+    }
+
+    return exceeded;
+}
+
+
+/********************************************************************************
+ * @brief Refill the rate limit buckets. Call the function periodically - e.g. once
+ *        per second if the max_count values of the table are messages per second.
+ *        The number of discarded messages is logged with the MSG2_RATE_LIMITED
+ *        message for each format ID whose messages were discarded.
+ ********************************************************************************/
+
+RTE_OPTIM_SIZE void rte_rate_limit_refill(void)
+{
+    for (uint32_t i = 0U; i < rte_limit_count; i++)
+    {
+        rte_rate_limit_t *limit = &rte_limit_table[i];
+        RTE_ENTER_CRITICAL()
+        uint32_t suppressed = limit->suppressed;
+        limit->suppressed = 0U;
+        limit->tokens = limit->max_count;
+        RTE_EXIT_CRITICAL()
+
+        if (suppressed != 0U)
+        {
+            RTE_MSG2(MSG2_RATE_LIMITED, F_SYSTEM, limit->fmt_id, suppressed)
+        }
+    }
+}
+#endif // RTE_RATE_LIMIT != 0
+
+
+#if RTE_DCACHE_SNAPSHOT != 0
+/********************************************************************************
+ * @brief Clean the data cache lines of the g_rtedbg structure written since the previous
+ *        call, so that the debug probe reads the current buffer content from the RAM.
+ *        Only the header and the part of the circular buffer between the previous and
+ *        the current buffer index are cleaned (the complete structure after rte_init()).
+ *        The priority ring is always cleaned completely.
+ *
+ * @note  Call the function before the buffer is transferred to the host and at least
+ *        once per buffer wrap-around - the part overwritten by a complete wrap-around
+ *        since the previous call can not be detected. Messages that are being written
+ *        at the moment of the call are completed in the cache and cleaned at the next call.
+ ********************************************************************************/
+
+RTE_OPTIM_SIZE void rte_prepare_snapshot(void)
+{
+    uint32_t index = g_rtedbg.buf_index;
+    uint32_t last_index = rte_snapshot_index;
+    rte_snapshot_index = index;
+
+    if (last_index == RTE_SNAPSHOT_ALL)
+    {
+        RTE_DCACHE_CLEAN(&g_rtedbg, RTE_HEADER_SIZE + ((RTE_BUFFER_WORDS + 4U) * sizeof(uint32_t)));
+    }
+    else
+    {
+        RTE_DCACHE_CLEAN(&g_rtedbg, RTE_HEADER_SIZE);
+        if (index < last_index)
+        {
+            // The index has wrapped around - clean to the end of the buffer (including the
+            // four additional words after the end) and then from the start of the buffer.
+            RTE_DCACHE_CLEAN(&g_rtedbg.buffer[last_index],
+                             ((RTE_BUFFER_WORDS + 4U) - last_index) * sizeof(uint32_t));
+            last_index = 0U;
+        }
+
+        if (index > last_index)
+        {
+            RTE_DCACHE_CLEAN(&g_rtedbg.buffer[last_index], (index - last_index) * sizeof(uint32_t));
+        }
+    }
+
+#if RTE_PRIO_BUFFER_SIZE != 0
+    RTE_DCACHE_CLEAN(&g_rtedbg_prio, sizeof(g_rtedbg_prio));
+#endif
+}
+
+
+/********************************************************************************
+ * @brief Check the g_rte_snapshot_request flag set by the host software and prepare
+ *        the snapshot if requested. Call the function periodically, e.g. from the idle
+ *        loop or a low priority timer interrupt. The flag is cleared when the buffer
+ *        content in the RAM is up to date - the host then transfers the data.
+ ********************************************************************************/
+
+RTE_OPTIM_SIZE void rte_snapshot_poll(void)
+{
+    if (g_rte_snapshot_request != 0U)
+    {
+        rte_prepare_snapshot();
+        g_rte_snapshot_request = 0U;
+        RTE_DATA_MEMORY_BARRIER();      // Ensure visibility of changes across all CPU cores.
+    }
+}
+#endif // RTE_DCACHE_SNAPSHOT != 0
+
+
 /********************************************************************************
  * @brief Save the new timestamp frequency to the g_rtedbg structure and log
  *        the information in the circular data buffer. Call this function after
@@ -917,14 +2006,149 @@ RTE_OPTIM_SIZE uint32_t rte_get_filter(void)
 RTE_OPTIM_SIZE void rte_timestamp_frequency(const uint32_t new_frequency)
 {
     g_rtedbg.timestamp_frequency = new_frequency;
+    RTE_UPDATE_HEADER_CHECK(RTE_MAIN_RTEDBG)
+#if RTE_PRIO_BUFFER_SIZE != 0
+    RTE_PRIO_RING->timestamp_frequency = new_frequency;
+    RTE_UPDATE_HEADER_CHECK(RTE_PRIO_RING)
+#endif
     RTE_MSG1(MSG1_TSTAMP_FREQUENCY, F_SYSTEM, new_frequency)
 }
+
+
+#if RTE_USE_LONG_TIMESTAMP != 0
+/***
+ * @brief Extend the timestamp counter value to 64 bits.
+ *        Must be called with interrupts disabled (see RTE_ENTER_CRITICAL).
+ *
+ * @return 64-bit timestamp (counter value aligned to bit 31 of the lower word).
+ */
+
+__STATIC_FORCEINLINE uint64_t rte_extend_timestamp(void)
+{
+    uint32_t timestamp =
+        (uint32_t)(rte_get_timestamp() << (32U - (RTE_TIMESTAMP_COUNTER_BITS)));
+
+    if (g_rte_tstamp.l > timestamp)    // Has the counter rolled over?
+    {
+        g_rte_tstamp.h++;
+    }
+
+    g_rte_tstamp.l = timestamp;
+#if RTE_LONG_TIMESTAMP_IN_MSG != 0
+    g_rte_tstamp.last_msg = timestamp;  // The long timestamp message is logged next
+#endif
+    return (uint64_t)timestamp | ((uint64_t)g_rte_tstamp.h << 32U);
+}
+
+
+/*********************************************************************************
+ * @brief  Log the long timestamp message. It is copied to the priority ring also if
+ *         the F_SYSTEM messages are not logged there (RTE_PRIO_FILTER_MASK) since the
+ *         priority ring can not be decoded without the long timestamps.
+ *
+ * @param  timestamp_h  Higher 32 bits of the long timestamp
+ *********************************************************************************/
+
+__STATIC_FORCEINLINE void rte_log_long_timestamp(const uint32_t timestamp_h)
+{
+    RTE_MSG1(MSG1_LONG_TIMESTAMP, F_SYSTEM, timestamp_h)
+#if (RTE_PRIO_BUFFER_SIZE != 0) && (((RTE_PRIO_FILTER_MASK) & 0x80000000UL) == 0U)
+    __rte_msg1_i(RTE_PRIO_RING, RTE_LONG_TSTAMP_FMT_ID, (rte_any32_t)timestamp_h);
+#endif
+}
+
+
+/*********************************************************************************
+ * @brief  Writes a message with a long timestamp to the buffer.
+ *         The low bits of the timestamp are included in the message words with the
+ *         format ID. Only the higher 32 bits are transmitted in the message's
+ *         data part.
+ *
+ * @note   The function is reentrant. The 64-bit timestamp is updated and the message
+ *         logged inside a short critical section. Use rte_long_timestamp_check() for
+ *         periodic calls - this function logs a message with every call.
+ *********************************************************************************/
+
+RTE_OPTIM_SIZE RTE_FAST_CODE void rte_long_timestamp(void)
+{
+    RTE_ENTER_CRITICAL()
+    uint64_t timestamp_64 = rte_extend_timestamp();
+    g_rte_tstamp.half = (uint32_t)(timestamp_64 >> (RTE_LONG_TSTAMP_SHIFT - 1U));
+    rte_log_long_timestamp((uint32_t)(timestamp_64 >> RTE_LONG_TSTAMP_SHIFT));
+    RTE_EXIT_CRITICAL()
+}
+
+
+/*********************************************************************************
+ * @brief  Extend the timestamp to 64 bits and write the long timestamp message only
+ *         when the short timestamp enters a new half period, i.e. before the short
+ *         timestamps of the messages become ambiguous for the decoder.
+ *
+ * @note   Call the function at least once per half period of the short timestamp
+ *         - 2^(30 - RTE_FMT_ID_BITS + RTE_TIMESTAMP_SHIFT) timestamp counter ticks,
+ *         e.g. from a timer interrupt or RTOS idle hook. More frequent calls are cheap
+ *         since no message is logged. The function is reentrant.
+ *********************************************************************************/
+
+RTE_OPTIM_SIZE void rte_long_timestamp_check(void)
+{
+    RTE_ENTER_CRITICAL()
+    uint64_t timestamp_64 = rte_extend_timestamp();
+    uint32_t half = (uint32_t)(timestamp_64 >> (RTE_LONG_TSTAMP_SHIFT - 1U));
+
+    if (half != g_rte_tstamp.half)
+    {
+        g_rte_tstamp.half = half;
+        rte_log_long_timestamp((uint32_t)(timestamp_64 >> RTE_LONG_TSTAMP_SHIFT));
+    }
+    RTE_EXIT_CRITICAL()
+}
+#endif // RTE_USE_LONG_TIMESTAMP != 0
 #endif  // !defined RTE_USE_INLINE_FUNCTIONS
 
 #if ((RTE_TIMESTAMP_COUNTER_BITS) - (RTE_TIMESTAMP_SHIFT)) < ((32U - 1U) - (RTE_FMT_ID_BITS))
 #error "The maximum RTE_TIMESTAMP_SHIFT value is limited to ensure the top logged timestamp bit flips."
 #endif
 
+#if (RTE_USE_LONG_TIMESTAMP != 0) && (RTE_LONG_TIMESTAMP_TIMER_IRQ != 0) && (!defined RTE_LONG_TSTAMP_IRQ_PERIOD)
+#error "RTE_LONG_TIMESTAMP_TIMER_IRQ is not supported by the selected timestamp timer driver."
+#endif
+
+#if (RTE_RATE_MONITOR != 0) && \
+    ((!defined RTE_RATE_BUDGET) || (!defined RTE_RATE_SHED_MASK) || (!defined RTE_RATE_RESTORE_WINDOWS))
+#error "RTE_RATE_BUDGET, RTE_RATE_SHED_MASK and RTE_RATE_RESTORE_WINDOWS must be defined if RTE_RATE_MONITOR is enabled."
+#endif
+
+#if (RTE_PRIO_BUFFER_SIZE != 0) && \
+    ((RTE_MINIMIZED_CODE_SIZE != 0) || (RTE_MSG_FILTERING_ENABLED == 0) || (!defined RTE_PRIO_FILTER_MASK))
+#error "RTE_PRIO_BUFFER_SIZE requires RTE_MINIMIZED_CODE_SIZE = 0, message filtering and RTE_PRIO_FILTER_MASK."
+#endif
+
+#if (RTE_PRIO_MIRROR != 0) && (RTE_PRIO_BUFFER_SIZE == 0)
+#error "RTE_PRIO_MIRROR requires the priority ring (RTE_PRIO_BUFFER_SIZE > 0)."
+#endif
+
+#if (RTE_BUFFER_SIZE_AT_RUNTIME != 0) && (!defined RTE_GET_BUFFER_SIZE)
+#error "RTE_GET_BUFFER_SIZE() must be defined if RTE_BUFFER_SIZE_AT_RUNTIME is enabled."
+#endif
+
+#if (RTE_DCACHE_SNAPSHOT != 0) && (!defined RTE_DCACHE_CLEAN)
+#error "RTE_DCACHE_CLEAN() must be defined if RTE_DCACHE_SNAPSHOT is enabled."
+#endif
+
+#if (RTE_INSTANCES != 0) && (RTE_MINIMIZED_CODE_SIZE != 0)
+#error "RTE_INSTANCES requires RTE_MINIMIZED_CODE_SIZE = 0."
+#endif
+
+#if (RTE_SUPPRESS_REPEATED != 0) && (RTE_MINIMIZED_CODE_SIZE != 0)
+#error "RTE_SUPPRESS_REPEATED requires RTE_MINIMIZED_CODE_SIZE = 0."
+#endif
+
+#if (RTE_SUPPRESS_REPEATED != 0) && \
+    ((RTE_REPEAT_TABLE_SIZE == 0U) || (((RTE_REPEAT_TABLE_SIZE) & ((RTE_REPEAT_TABLE_SIZE) - 1U)) != 0U))
+#error "RTE_REPEAT_TABLE_SIZE must be a power of 2."
+#endif
+
 #if (RTE_MINIMIZED_CODE_SIZE > 0) && defined RTE_USE_INLINE_FUNCTIONS
 #error "RTE_MINIMIZED_CODE_SIZE must be 0 if inline RTEdbg functions are used."
 #endif
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) Branko Premzel.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/***
+ * @file   erase_segment_sim.c
+ * @author Branko Premzel
+ * @brief  Linux test program for the segmented erase of the circular buffer
+ *         (RTE_ERASE_SEGMENT_SIZE and RTE_ERASE_SEGMENT_HOOK()). The g_rtedbg buffer is
+ *         erased by rte_init() and a 32 MB buffer of an additional instance allocated on
+ *         the heap by rte_init_i(). The buffers are filled with a test pattern before.
+ *         The following is checked:
+ *         - the hook is called once after each segment (the last one may be shorter),
+ *         - the segments are erased in turn - at each hook call the words up to the end
+ *           of the segment are erased and the following ones are not,
+ *         - the complete buffer and trailer are erased and nothing after them.
+ *         See the Readme.md for the build instructions.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "main.h"
+
+// STM32H743 demo configuration with the segmented erase and one additional instance.
+// The segment size is small, so that the g_rtedbg buffer is also erased in several segments.
+#include "rtedbg_config.h"
+#undef  RTE_ERASE_SEGMENT_SIZE
+#define RTE_ERASE_SEGMENT_SIZE   500U
+#undef  RTE_INSTANCES
+#define RTE_INSTANCES            1
+void sim_erase_hook(void);
+#define RTE_ERASE_SEGMENT_HOOK()  sim_erase_hook()
+
+#include "rtedbg.c"             // The library is compiled with this configuration
+
+#define SIM_PATTERN        0xA5A5A5A5U
+#define SIM_INST_WORDS     (8U * 1024U * 1024U)     // 32 MB circular buffer of the instance
+
+DWT_Type sim_dwt;
+CoreDebug_Type sim_core_debug;
+uint32_t SystemCoreClock = 480000000U;
+
+static uint32_t *sim_buffer;        // Buffer that is being erased
+static uint32_t sim_words;          // Number of words to erase (buffer + trailer)
+static uint32_t sim_hooks;          // Number of hook calls for the buffer
+static uint32_t sim_errors;
+
+
+/***
+ * @brief Report an error found by the simulator.
+ *
+ * @param text   Error description
+ * @param value  Additional information (e.g. the word index)
+ */
+
+static void sim_error(const char * const text, const uint32_t value)
+{
+    if (sim_errors < 20U)           // Report only the first errors
+    {
+        printf("ERROR: %s (%u)\n", text, value);
+    }
+    sim_errors++;
+}
+
+
+/***
+ * @brief RTE_ERASE_SEGMENT_HOOK() - check the erased part of the buffer after each segment.
+ */
+
+void sim_erase_hook(void)
+{
+    if ((sim_hooks * RTE_ERASE_SEGMENT_SIZE) >= sim_words)
+    {
+        sim_error("Hook called after the end of the buffer", sim_hooks);
+        return;
+    }
+
+    sim_hooks++;
+    uint32_t erased = sim_hooks * RTE_ERASE_SEGMENT_SIZE;
+    if (erased > sim_words)
+    {
+        erased = sim_words;         // The last segment is shorter
+    }
+
+    if ((sim_buffer[0] != RTE_ERASED_STATE) || (sim_buffer[erased - 1U] != RTE_ERASED_STATE))
+    {
+        sim_error("Segment not erased before the hook call", sim_hooks);
+    }
+
+    if ((erased < sim_words) && (sim_buffer[erased] != SIM_PATTERN))
+    {
+        sim_error("Word after the segment erased before the hook call", sim_hooks);
+    }
+}
+
+
+/***
+ * @brief Fill the buffer with the test pattern before the erase.
+ *
+ * @param buffer  Circular buffer
+ * @param words   Number of words to erase (buffer + trailer)
+ */
+
+static void sim_prepare(uint32_t * const buffer, const uint32_t words)
+{
+    sim_buffer = buffer;
+    sim_words = words;
+    sim_hooks = 0U;
+    memset(buffer, 0xA5, words * sizeof(uint32_t));
+}
+
+
+/***
+ * @brief Check the buffer after the erase.
+ *
+ * @param name  Buffer name
+ */
+
+static void sim_check(const char * const name)
+{
+    uint32_t segments = (sim_words + RTE_ERASE_SEGMENT_SIZE - 1U) / RTE_ERASE_SEGMENT_SIZE;
+    if (sim_hooks != segments)
+    {
+        sim_error("Wrong number of hook calls", sim_hooks);
+    }
+
+    for (uint32_t i = 0U; i < sim_words; i++)
+    {
+        if (sim_buffer[i] != RTE_ERASED_STATE)
+        {
+            sim_error("Word not erased", i);
+            break;
+        }
+    }
+
+    printf("%s: %u words erased in %u segments\n", name, sim_words, sim_hooks);
+}
+
+
+/***
+ * @brief Erase the g_rtedbg buffer and the buffer of a large instance on the heap.
+ */
+
+int main(void)
+{
+    sim_prepare(&g_rtedbg.buffer[0], RTE_BUFFER_WORDS + 4U);
+    rte_init(0xFFFFFFFFU, RTE_RESTART_LOGGING);
+    sim_check("g_rtedbg");
+
+    // Instance with a 32 MB buffer + trailer + one guard word
+    rtedbg_inst_t *inst = malloc(RTE_HEADER_SIZE + ((SIM_INST_WORDS + 5U) * sizeof(uint32_t)));
+    if (inst == NULL)
+    {
+        printf("The instance buffer can not be allocated.\n");
+        return 2;
+    }
+
+    memset(inst, 0, RTE_HEADER_SIZE);
+    sim_prepare(&inst->buffer[0], SIM_INST_WORDS + 4U);
+    inst->buffer[SIM_INST_WORDS + 4U] = SIM_PATTERN;
+    rte_init_i(inst, SIM_INST_WORDS, 0xFFFFFFFFU, RTE_RESTART_LOGGING);
+    sim_check("instance");
+    if (inst->buffer[SIM_INST_WORDS + 4U] != SIM_PATTERN)
+    {
+        sim_error("Word after the trailer erased", SIM_INST_WORDS + 4U);
+    }
+
+    // The instance is not erased again if logging continues after a reset
+    inst->buffer[0] = SIM_PATTERN;
+    sim_hooks = 0U;
+    rte_init_i(inst, SIM_INST_WORDS, 0xFFFFFFFFU, RTE_CONTINUE_LOGGING);
+    if ((sim_hooks != 0U) || (inst->buffer[0] != SIM_PATTERN))
+    {
+        sim_error("Instance erased although logging continues", sim_hooks);
+    }
+
+    free(inst);
+    printf("Segment size %u: %s\n", RTE_ERASE_SEGMENT_SIZE, (sim_errors == 0U) ? "OK" : "FAILED");
+    return (sim_errors == 0U) ? 0 : 1;
+}
+
+/*==== End of file ====*/
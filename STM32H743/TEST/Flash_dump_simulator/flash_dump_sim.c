@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) Branko Premzel.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/***
+ * @file   flash_dump_sim.c
+ * @author Branko Premzel
+ * @brief  Linux simulator for the rte_flash_dump.c (STM32H743 demo). The flash dump area
+ *         (the last two sectors of bank 2) is mapped to its STM32H743 address and the
+ *         bank 2 flash controller registers are emulated. A sequence of resets is
+ *         simulated - each one prepares the slot with rte_flash_dump_init() and saves
+ *         the logged data with rte_flash_dump_save(). The following is checked:
+ *         - the latest dump is found and it is a copy of the g_rtedbg structure,
+ *         - the sequence numbers increase and the slots are used in turn (wear leveling),
+ *         - the sector with the latest dump is never erased,
+ *         - only the prepared slot is written and only erased flash words are programmed,
+ *         - a slot with an incomplete dump (power failure during the saving) is not
+ *           programmed again before it is erased.
+ *         See the Readme.md for the build instructions.
+ */
+
+#define _DEFAULT_SOURCE             // mmap() flags
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "main.h"
+#include "rtedbg.h"
+#include "rtedbg_int.h"
+#include "rte_flash_dump.h"
+
+#define SIM_RESETS         40U      // Number of simulated resets (more than the number of slots)
+#define SIM_SLOTS          ((RTE_DUMP_SECTORS * RTE_DUMP_SECTOR_SIZE) / RTE_DUMP_SLOT_SIZE)
+#define SIM_AREA_SIZE      (RTE_DUMP_SECTORS * RTE_DUMP_SECTOR_SIZE)
+#define SIM_FLASH_WORD     (FLASH_NB_32BITWORD_IN_FLASHWORD * 4U)
+
+DWT_Type sim_dwt;
+CoreDebug_Type sim_core_debug;
+uint32_t SystemCoreClock = 480000000U;
+
+static FLASH_TypeDef sim_flash_regs;
+static uint8_t *sim_area;                       // Flash dump area mapped to RTE_DUMP_AREA_START
+static uint8_t sim_copy[SIM_AREA_SIZE];         // Flash dump area before rte_flash_dump_save()
+static uint32_t sim_erased[RTE_DUMP_SECTORS];   // Number of erases of each sector
+static uint32_t sim_errors;
+
+
+/***
+ * @brief Report an error found by the simulator.
+ *
+ * @param text   Error description
+ * @param value  Additional information (e.g. the address)
+ */
+
+static void sim_error(const char * const text, const uint32_t value)
+{
+    if (sim_errors < 20U)           // Report only the first errors
+    {
+        printf("ERROR: %s (0x%08X)\n", text, value);
+    }
+    sim_errors++;
+}
+
+
+/***
+ * @brief Emulation of the bank 2 flash controller. The function is called at each
+ *        FLASH register access - a started sector erase is executed immediately.
+ *
+ * @return Emulated flash register set
+ */
+
+FLASH_TypeDef * sim_flash(void)
+{
+    if ((sim_flash_regs.CR2 & FLASH_CR_START) != 0U)
+    {
+        uint32_t sector = (sim_flash_regs.CR2 & FLASH_CR_SNB) >> FLASH_CR_SNB_Pos;
+        uint32_t address = FLASH_BANK2_BASE + (sector * FLASH_SECTOR_SIZE);
+
+        if ((sim_flash_regs.CR2 & FLASH_CR_LOCK) != 0U)
+        {
+            sim_error("Sector erase started with the flash locked", address);
+        }
+        else if (((sim_flash_regs.CR2 & FLASH_CR_SER) == 0U)
+                 || (address < RTE_DUMP_AREA_START)
+                 || (address >= (RTE_DUMP_AREA_START + SIM_AREA_SIZE)))
+        {
+            sim_error("Erase outside of the flash dump area", address);
+        }
+        else
+        {
+            memset(&sim_area[address - RTE_DUMP_AREA_START], 0xFF, FLASH_SECTOR_SIZE);
+            sim_erased[(address - RTE_DUMP_AREA_START) / FLASH_SECTOR_SIZE]++;
+        }
+
+        sim_flash_regs.CR2 &= ~FLASH_CR_START;
+    }
+
+    if (sim_flash_regs.KEYR2 == FLASH_KEY2)
+    {
+        sim_flash_regs.CR2 &= ~FLASH_CR_LOCK;   // Unlock sequence (the first key is not checked)
+        sim_flash_regs.KEYR2 = 0U;
+    }
+
+    return &sim_flash_regs;
+}
+
+
+/***
+ * @brief Log a few messages - the buffer index moves on and wraps around.
+ *
+ * @param count  Number of messages
+ */
+
+static void sim_log_messages(const uint32_t count)
+{
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        sim_dwt.CYCCNT += 1000U;
+        RTE_MSG2(MSG2_LOAD_SHEDDING, F_SYSTEM, i, sim_dwt.CYCCNT)
+    }
+}
+
+
+/***
+ * @brief Check the flash words written by the rte_flash_dump_save(). Only the words of
+ *        one slot may have been changed and all of them must have been erased before.
+ *
+ * @param slot  Address of the slot with the new dump
+ */
+
+static void sim_check_programming(const uint32_t slot)
+{
+    for (uint32_t offset = 0U; offset < SIM_AREA_SIZE; offset += SIM_FLASH_WORD)
+    {
+        if (memcmp(&sim_area[offset], &sim_copy[offset], SIM_FLASH_WORD) == 0)
+        {
+            continue;
+        }
+
+        uint32_t address = RTE_DUMP_AREA_START + offset;
+        if ((address < slot) || (address >= (slot + RTE_DUMP_SLOT_SIZE)))
+        {
+            sim_error("Flash word outside of the slot written", address);
+        }
+
+        for (uint32_t i = 0U; i < SIM_FLASH_WORD; i++)
+        {
+            if (sim_copy[offset + i] != 0xFFU)
+            {
+                sim_error("Flash word programmed without erase", address);
+                break;
+            }
+        }
+    }
+}
+
+
+/***
+ * @brief Check if the slot is completely erased.
+ *
+ * @param slot  Slot start address
+ *
+ * @return 1 - erased, 0 - not erased
+ */
+
+static uint32_t sim_slot_erased(const uint32_t slot)
+{
+    const uint8_t *data = &sim_area[slot - RTE_DUMP_AREA_START];
+
+    for (uint32_t i = 0U; i < RTE_DUMP_SLOT_SIZE; i++)
+    {
+        if (data[i] != 0xFFU)
+        {
+            return 0U;
+        }
+    }
+
+    return 1U;
+}
+
+
+/***
+ * @brief Check if the dump is a copy of the g_rtedbg structure.
+ *
+ * @param record  Slot record of the dump
+ */
+
+static void sim_check_image(const rte_dump_record_t * const record)
+{
+    if (record->image_size != sizeof(rtedbg_t))
+    {
+        sim_error("Wrong image size", record->image_size);
+    }
+
+    if (memcmp(&record[1], &g_rtedbg, sizeof(rtedbg_t)) != 0)
+    {
+        // The circular buffer words that were not saved are left erased
+        const uint32_t *image = (const uint32_t *)(const void *)&record[1];
+        const uint32_t *source = (const uint32_t *)(const void *)&g_rtedbg;
+        for (uint32_t i = 0U; i < (sizeof(rtedbg_t) / 4U); i++)
+        {
+            if ((image[i] != source[i]) && (image[i] != RTE_ERASED_STATE))
+            {
+                sim_error("Image differs from g_rtedbg at word", i);
+                break;
+            }
+        }
+    }
+}
+
+
+/***
+ * @brief Simulate a sequence of resets with a data dump before each of them.
+ */
+
+int main(void)
+{
+    void *area = mmap((void *)RTE_DUMP_AREA_START, SIM_AREA_SIZE, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+    if (area != (void *)RTE_DUMP_AREA_START)
+    {
+        printf("The flash dump area can not be mapped to 0x%08lX.\n", RTE_DUMP_AREA_START);
+        return 2;
+    }
+    sim_area = (uint8_t *)area;
+    memset(sim_area, 0xA5, SIM_AREA_SIZE);      // The flash memory has not been erased
+    sim_flash_regs.CR2 = FLASH_CR_LOCK;
+
+    rte_init(0xFFFFFFFFU, RTE_RESTART_LOGGING);
+    const rte_dump_record_t *previous = NULL;
+
+    for (uint32_t reset = 0U; reset < SIM_RESETS; reset++)
+    {
+        sim_log_messages(97U + (reset * 31U));
+
+        // Startup after the reset - the sector with the latest dump must be kept
+        rte_flash_dump_init();
+        const rte_dump_record_t *latest = rte_flash_dump_latest();
+        if (latest != previous)
+        {
+            sim_error("Latest dump lost at the startup", (uint32_t)(uintptr_t)previous);
+        }
+
+        if ((reset % 7U) == 3U)
+        {
+            // Power failure during the dump - part of the image written, no slot record.
+            // The dump is written to the next erased slot after the latest one.
+            uint32_t slot = (uint32_t)(uintptr_t)previous;
+            do
+            {
+                slot += RTE_DUMP_SLOT_SIZE;
+                if (slot >= (RTE_DUMP_AREA_START + SIM_AREA_SIZE))
+                {
+                    slot = RTE_DUMP_AREA_START;
+                }
+            }
+            while (sim_slot_erased(slot) == 0U);
+
+            memset((void *)(uintptr_t)(slot + SIM_FLASH_WORD), 0x00, SIM_FLASH_WORD);
+            rte_flash_dump_init();
+            if (rte_flash_dump_latest() != previous)
+            {
+                sim_error("Latest dump lost after the power failure", slot);
+            }
+        }
+
+        // Fatal error - save the logged data
+        memcpy(sim_copy, sim_area, SIM_AREA_SIZE);
+        rte_flash_dump_save();
+        latest = rte_flash_dump_latest();
+        if (latest == NULL)
+        {
+            sim_error("Dump not found", reset);
+            break;
+        }
+
+        uint32_t slot = (uint32_t)(uintptr_t)latest;
+        sim_check_programming(slot);
+        sim_check_image(latest);
+
+        if ((previous != NULL) && (latest->sequence != (previous->sequence + 1U)))
+        {
+            sim_error("Wrong sequence number", latest->sequence);
+        }
+
+        printf("Reset %2u: dump #%2u in slot %2u, buffer index %4u\n", reset, latest->sequence,
+               (uint32_t)((slot - RTE_DUMP_AREA_START) / RTE_DUMP_SLOT_SIZE), g_rtedbg.buf_index);
+        previous = latest;
+    }
+
+    for (uint32_t i = 0U; i < RTE_DUMP_SECTORS; i++)
+    {
+        printf("Sector %u erased %u times\n", i, sim_erased[i]);
+    }
+
+    printf("%u slots, %u resets: %s\n", (uint32_t)SIM_SLOTS, SIM_RESETS,
+           (sim_errors == 0U) ? "OK" : "FAILED");
+    return (sim_errors == 0U) ? 0 : 1;
+}
+
+/*==== End of file ====*/
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Branko Premzel.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/***
+ * @file   main.h
+ * @author Branko Premzel
+ * @brief  Host (Linux) replacement of the STM32H743 main.h for the flash dump simulator.
+ *         It defines the CMSIS functions used by the RTEdbg library and the flash
+ *         registers and constants used by the rte_flash_dump.c. The flash controller
+ *         registers are emulated by the flash_dump_sim.c.
+ */
+
+#ifndef SIM_MAIN_H
+#define SIM_MAIN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define UNUSED(x) (void)(x)
+#define __STATIC_FORCEINLINE static inline __attribute__((always_inline))
+
+// Cortex-M core - single threaded host program
+#define __LDREXW(address)         (*(address))
+#define __STREXW(value, address)  ((*(address) = (value)), 0U)
+#define __CLREX()
+#define __DMB()
+#define __ISB()
+#define __DSB()
+#define __DCACHE_PRESENT  0U
+
+__STATIC_FORCEINLINE uint32_t __get_PRIMASK(void) { return 0U; }
+__STATIC_FORCEINLINE void __disable_irq(void) { }
+__STATIC_FORCEINLINE void __enable_irq(void) { }
+
+// Timestamp timer (DWT cycle counter)
+typedef struct { volatile uint32_t CTRL; volatile uint32_t CYCCNT; } DWT_Type;
+typedef struct { volatile uint32_t DEMCR; } CoreDebug_Type;
+extern DWT_Type sim_dwt;
+extern CoreDebug_Type sim_core_debug;
+#define DWT        (&sim_dwt)
+#define CoreDebug  (&sim_core_debug)
+#define DWT_CTRL_CYCCNTENA_Msk        1UL
+#define CoreDebug_DEMCR_TRCENA_Msk    (1UL << 24U)
+extern uint32_t SystemCoreClock;
+
+// Flash memory controller - bank 2 registers only
+typedef struct
+{
+    volatile uint32_t KEYR2;
+    volatile uint32_t CR2;
+    volatile uint32_t SR2;
+    volatile uint32_t CCR2;
+} FLASH_TypeDef;
+
+FLASH_TypeDef * sim_flash(void);
+#define FLASH  (sim_flash())        // Each register access executes the pending erase
+
+#define FLASH_BANK2_BASE                 0x08100000UL
+#define FLASH_END                        0x081FFFFFUL
+#define FLASH_SECTOR_SIZE                0x00020000UL
+#define FLASH_NB_32BITWORD_IN_FLASHWORD  8U
+#define FLASH_KEY1                       0x45670123UL
+#define FLASH_KEY2                       0xCDEF89ABUL
+
+#define FLASH_CR_LOCK      (1UL << 0U)
+#define FLASH_CR_PG        (1UL << 1U)
+#define FLASH_CR_SER       (1UL << 2U)
+#define FLASH_CR_PSIZE     (3UL << 4U)
+#define FLASH_CR_PSIZE_1   (2UL << 4U)
+#define FLASH_CR_START     (1UL << 7U)
+#define FLASH_CR_SNB_Pos   8U
+#define FLASH_CR_SNB       (7UL << FLASH_CR_SNB_Pos)
+
+#define FLASH_SR_BSY       (1UL << 0U)
+#define FLASH_SR_QW        (1UL << 2U)
+
+#define FLASH_CCR_CLR_EOP     (1UL << 16U)
+#define FLASH_CCR_CLR_WRPERR  (1UL << 17U)
+#define FLASH_CCR_CLR_PGSERR  (1UL << 18U)
+#define FLASH_CCR_CLR_STRBERR (1UL << 19U)
+#define FLASH_CCR_CLR_INCERR  (1UL << 21U)
+#define FLASH_CCR_CLR_OPERR   (1UL << 22U)
+
+#endif /* SIM_MAIN_H */
+
+/*==== End of file ====*/
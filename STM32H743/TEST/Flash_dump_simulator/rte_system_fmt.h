@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) Branko Premzel.
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+/***
+ * @file   rte_system_fmt.h
+ * @author Branko Premzel
+ * @brief  Format IDs of the RTEdbg library messages for the flash dump simulator. In the
+ *         firmware they are defined by the RTEmsg application from the Fmt/rte_system_fmt.h.
+ */
+
+#ifndef SIM_RTE_SYSTEM_FMT_H
+#define SIM_RTE_SYSTEM_FMT_H
+
+#define F_SYSTEM                0U
+#define MSG1_LONG_TIMESTAMP     2U
+#define MSG1_TSTAMP_FREQUENCY   4U
+#define MSG2_LOAD_SHEDDING      8U
+#define MSG2_RATE_LIMITED      12U
+#define MSG2_LOG_RESUMED       16U
+#define MSG4_MSG_REPEATED      32U
+
+#endif /* SIM_RTE_SYSTEM_FMT_H */
+
+/*==== End of file ====*/
@@ -85,11 +85,8 @@ void TIM2_IRQHandler(void)
   HAL_TIM_IRQHandler(&htim2);
   /* USER CODE BEGIN TIM2_IRQn 1 */
   //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-  // Log the long timestamp every eight tick periods (8 ms)
-  if ((uwTick & 7u) == 0)
-  {
-      rte_long_timestamp();
-  }
+  // Log the long timestamp only when the short timestamp would become ambiguous
+  rte_long_timestamp_check();
   //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   /* USER CODE END TIM2_IRQn 1 */
 }
@@ -291,7 +291,7 @@ typedef struct
 
 void rte_get_buffer_info(rte_buf_data_t * rte_buff)
 {
-    const uint32_t total_size = sizeof(g_rtedbg.buffer) / sizeof(uint32_t);
+    const uint32_t total_size = g_rtedbg.buffer_size;
     uint32_t count = total_size;
 
 #if RTE_SINGLE_SHOT_ENABLED != 0
@@ -328,6 +328,7 @@ void rte_get_buffer_info(rte_buf_data_t * rte_buff)
 
 void Send_data_to_host(void)
 {
+    rte_flush_repeated();       // Log the counted repetitions (see RTE_SUPPRESS_REPEATED)
     rte_set_filter(0U);         // Disable message logging
     // Note: Any further logging attempts are disabled but all data may not be written.
     // Add a delay if writing should end, e.g. in another RTOS task.
@@ -12,4 +12,17 @@
 /* Long timestamp = top 32-bits of the long timestamp */
 
 // MSG1_TSTAMP_FREQUENCY "Timestamp frequency: %[32u](*1e-6)g MHz"
+
+/* Optional system messages */
+// MSG2_LOAD_SHEDDING "Load shedding: filter = 0x%08X, %u words logged in the last window"
+/* Logged by rte_rate_monitor() when a filter group is disabled or re-enabled */
+
+// MSG2_RATE_LIMITED "Rate limit: format ID %u - %u messages discarded"
+/* Logged by rte_rate_limit_refill() for each rate limited format ID */
+
+// MSG4_MSG_REPEATED "Message with format ID %u repeated %u times, first at %u, last at %u (timestamp units)"
+/* Logged before the next different message or by rte_flush_repeated() - see RTE_SUPPRESS_REPEATED */
+
+// MSG2_LOG_RESUMED "Logging resumed after reset: buffer index %u, %u words of an unfinished message erased"
+/* Reset boundary logged by rte_init() in the post-mortem mode - see RTE_RESUME_CHECK */
 #endif
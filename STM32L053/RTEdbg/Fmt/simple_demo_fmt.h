@@ -33,6 +33,9 @@
 // MSG3_COMBINED "Combined values demo: \n"
 //                "   value1=%g, value2=%g, value3=%[16i]d, value4=%[6u]u, value5=%[10i]d"
 
+// MSG2_PACKED_DEMO "Packed values: current=%[16i]d mA, voltage=%[16u]u mV, "
+//                  "bytes=%[8u]u, %[8u]u, %[8u]u, %[8u]u"
+
 // MSG0_TRIGGER_SYS_ERROR
 //  "\n  --> [Triggering a system error]-[触发系统错误]\n"
 
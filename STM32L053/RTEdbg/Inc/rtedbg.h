@@ -38,6 +38,79 @@
 #define RTE_ENABLED  0
 #endif
 
+/* Compile-time message filter for a source file (module). Define it before including
+ * rtedbg.h - e.g. #define RTE_MODULE_FILTER_MASK 0xF0000000UL to keep only the messages
+ * of filter groups #0 to #3 in the code. See also RTE_COMPILE_FILTER_MASK.
+ */
+#if !defined RTE_MODULE_FILTER_MASK
+#define RTE_MODULE_FILTER_MASK  0xFFFFFFFFUL
+#endif
+
+/* Default values for optional configuration parameters not defined in rtedbg_config.h */
+#if !defined RTE_LONG_TIMESTAMP_TIMER_IRQ
+#define RTE_LONG_TIMESTAMP_TIMER_IRQ  0
+#endif
+
+#if !defined RTE_LONG_TIMESTAMP_IN_MSG
+#define RTE_LONG_TIMESTAMP_IN_MSG  0
+#endif
+
+#if !defined RTE_FMT_ID_FILTER
+#define RTE_FMT_ID_FILTER  0
+#endif
+
+#if !defined RTE_INLINE_FILTER_CHECK
+#define RTE_INLINE_FILTER_CHECK  0
+#endif
+
+#if !defined RTE_COMPILE_FILTER_MASK
+#define RTE_COMPILE_FILTER_MASK  0xFFFFFFFFUL
+#endif
+
+#if !defined RTE_RATE_MONITOR
+#define RTE_RATE_MONITOR  0
+#endif
+
+#if !defined RTE_RATE_LIMIT
+#define RTE_RATE_LIMIT  0
+#endif
+
+#if !defined RTE_SUPPRESS_REPEATED
+#define RTE_SUPPRESS_REPEATED  0
+#endif
+
+#if !defined RTE_REPEAT_TABLE_SIZE
+#define RTE_REPEAT_TABLE_SIZE  4U
+#endif
+
+#if !defined RTE_PRIO_BUFFER_SIZE
+#define RTE_PRIO_BUFFER_SIZE  0U
+#endif
+
+#if !defined RTE_PRIO_MIRROR
+#define RTE_PRIO_MIRROR  0
+#endif
+
+#if !defined RTE_INSTANCES
+#define RTE_INSTANCES  0
+#endif
+
+#if !defined RTE_BUFFER_SIZE_AT_RUNTIME
+#define RTE_BUFFER_SIZE_AT_RUNTIME  0
+#endif
+
+#if !defined RTE_DCACHE_SNAPSHOT
+#define RTE_DCACHE_SNAPSHOT  0
+#endif
+
+#if !defined RTE_ERASE_SEGMENT_SIZE
+#define RTE_ERASE_SEGMENT_SIZE  0U
+#endif
+
+#if !defined RTE_RESUME_CHECK
+#define RTE_RESUME_CHECK  0
+#endif
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -85,6 +158,21 @@ extern "C" {
 #define RTE_PARAM(par)  par
 #endif
 
+/* Data logging structure - defined in rtedbg_int.h */
+typedef struct rtedbg rtedbg_t;
+
+/* Additional data logging instance or the priority ring - defined in rtedbg_int.h */
+typedef struct rtedbg_inst rtedbg_inst_t;
+
+/* Rate limit table entry for the rte_rate_limit_init() - see RTE_RATE_LIMIT. */
+typedef struct
+{
+    uint16_t fmt_id;        // Format ID of the rate limited message (e.g. MSG1_ADC_OVERRUN)
+    uint16_t max_count;     // Max. number of messages logged per refill period
+    uint16_t tokens;        // Remaining number of messages in this period (set by the library)
+    uint16_t suppressed;    // Number of discarded messages in this period (set by the library)
+} rte_rate_limit_t;
+
 
 /************************************************************************************
  * Functions that "convert" the float or double value to uint32_t
@@ -117,6 +205,24 @@ __STATIC_FORCEINLINE uint32_t double_par(const double number)
     return value.u;
 }
 
+/* Pack two 16-bit or four 8-bit values into one 32-bit DATA word. The first value is
+ * in the lowest bits - decode the values with %[16u] / %[16i] or %[8u] / %[8i], e.g.:
+ *   RTE_MSG1(MSG1_PACKED, F_SYSTEM, pack16_par((uint16_t)current, voltage))
+ *   // MSG1_PACKED "current=%[16i]d mA, voltage=%[16u]u mV"
+ * Small values that change slowly (counters, states, ADC samples) take a quarter or
+ * half of the buffer space.
+ */
+__STATIC_FORCEINLINE uint32_t pack16_par(const uint16_t low, const uint16_t high)
+{
+    return (uint32_t)low | ((uint32_t)high << 16U);
+}
+
+__STATIC_FORCEINLINE uint32_t pack8_par(const uint8_t b0, const uint8_t b1,
+                                        const uint8_t b2, const uint8_t b3)
+{
+    return (uint32_t)b0 | ((uint32_t)b1 << 8U) | ((uint32_t)b2 << 16U) | ((uint32_t)b3 << 24U);
+}
+
 
 #if defined(_lint) && defined(RTE_USE_ANY_TYPE_UNION)
 #undef RTE_USE_ANY_TYPE_UNION
@@ -282,6 +388,30 @@ typedef union {
 #define RTE_PACK_MSGX(filter, fmt)    (fmt)
 #endif  // _lint
 
+/* Compile-time filter. Messages of filter groups excluded by RTE_COMPILE_FILTER_MASK or
+ * RTE_MODULE_FILTER_MASK are removed by the compiler (constant condition). Filter #0 is
+ * used for system messages and is always compiled in.
+ */
+#define RTE_MSG_COMPILED(filter_no)                                                       \
+    ((((RTE_COMPILE_FILTER_MASK) & (RTE_MODULE_FILTER_MASK) & 0xFFFFFFFFUL) | 0x80000000UL) \
+     & (0x80000000UL >> ((uint32_t)(filter_no) & 0x1FU)))
+
+/* Optional check of the message filter at the call site. The logging function is not
+ * called (and its arguments are not evaluated) if the message filter group is disabled.
+ */
+#if (RTE_INLINE_FILTER_CHECK != 0) && (RTE_MSG_FILTERING_ENABLED != 0)
+extern rtedbg_t g_rtedbg;
+
+/* Message filter word of g_rtedbg (second word of the header - see rtedbg_int.h) */
+#define RTE_FILTER_VALUE()  (((const volatile uint32_t *)(const void *)&g_rtedbg)[1])
+
+#define RTE_IF_MSG_ENABLED(filter_no) \
+    if ((RTE_MSG_COMPILED(filter_no) & RTE_FILTER_VALUE()) != 0U)
+#else
+#define RTE_IF_MSG_ENABLED(filter_no) \
+    if (RTE_MSG_COMPILED(filter_no) != 0U)
+#endif
+
 /***
  * THE FOLLOWING MACROS COMPOSE THE FORMAT ID, EXTENDED DATA, AND THE FILTER NUMBER
  * AND ALLOW THESE VALUES TO BE VERIFIED AT COMPILATION TIME.
@@ -295,18 +425,21 @@ typedef union {
 #define RTE_MSG0(fmt, filter_no)                                                    \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 0U);                                       \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_msg0(RTE_PACK(filter_no, fmt, 0U));                                       \
 }
 
 #define RTE_MSG1(fmt, filter_no, data1)                                             \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 1U);                                       \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_msg1(RTE_PACK(filter_no, fmt, 1U), (rte_any32_t)(data1));                 \
 }
 
 #define RTE_MSG2(fmt, filter_no, data1, data2)                                      \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 3U);                                       \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_msg2(RTE_PACK(filter_no, fmt, 2U), (rte_any32_t)(data1),                  \
                (rte_any32_t)(data2));                                               \
 }
@@ -314,6 +447,7 @@ typedef union {
 #define RTE_MSG3(fmt, filter_no, data1, data2, data3)                               \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 7U);                                       \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_msg3(RTE_PACK(filter_no, fmt, 3U), (rte_any32_t)(data1),                  \
                (rte_any32_t)(data2), (rte_any32_t)(data3));                         \
 }
@@ -321,6 +455,7 @@ typedef union {
 #define RTE_MSG4(fmt, filter_no, data1, data2, data3, data4)                        \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 15U);                                      \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_msg4(RTE_PACK(filter_no, fmt, 4U), (rte_any32_t)(data1),                  \
                (rte_any32_t)(data2), (rte_any32_t)(data3),                          \
                (rte_any32_t)(data4));                                               \
@@ -334,6 +469,7 @@ __STATIC_FORCEINLINE uint32_t _rte_cvt(rte_any32_t value)
 #define RTE_MSG5(fmt, filter_no, data1, data2, data3, data4, data5)                 \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 15U);                                      \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     do {                                                                            \
         uint32_t data[5];                                                           \
         data[0U] = _rte_cvt((rte_any32_t)(data1));                                  \
@@ -349,6 +485,7 @@ __STATIC_FORCEINLINE uint32_t _rte_cvt(rte_any32_t value)
 #define RTE_MSG6(fmt, filter_no, data1, data2, data3, data4, data5, data6)          \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 15U);                                      \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     do {                                                                            \
         uint32_t data[6];                                                           \
         data[0U] = _rte_cvt((rte_any32_t)(data1));                                  \
@@ -365,6 +502,7 @@ __STATIC_FORCEINLINE uint32_t _rte_cvt(rte_any32_t value)
 #define RTE_MSG7(fmt, filter_no, data1, data2, data3, data4, data5, data6, data7)   \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 15U);                                      \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     do {                                                                            \
         uint32_t data[7];                                                           \
         data[0U] = _rte_cvt((rte_any32_t)(data1));                                  \
@@ -382,6 +520,7 @@ __STATIC_FORCEINLINE uint32_t _rte_cvt(rte_any32_t value)
 #define RTE_MSG8(fmt, filter_no, data1, data2, data3, data4, data5, data6, data7, data8) \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 15U);                                      \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     do {                                                                            \
         uint32_t data[8];                                                           \
         data[0U] = _rte_cvt((rte_any32_t)(data1));                                  \
@@ -400,12 +539,14 @@ __STATIC_FORCEINLINE uint32_t _rte_cvt(rte_any32_t value)
 #define INTRTE_EXT_MSG0(fmt, filter_no, ext_data, mask)                             \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, mask);                                     \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_msg0(RTE_PACK(filter_no, (fmt | ((ext_data) & mask)), 0U));               \
 }
 
 #define INTRTE_EXT_MSG1(fmt, filter_no, data1, ext_data, mask)                      \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, mask);                                     \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_msg1(RTE_PACK(filter_no, fmt | (((ext_data) & (mask >> 1U)) << 1U), 1U),  \
                (rte_any32_t)(data1));                                               \
 }
@@ -413,6 +554,7 @@ __STATIC_FORCEINLINE uint32_t _rte_cvt(rte_any32_t value)
 #define INTRTE_EXT_MSG2(fmt, filter_no, data1, data2, ext_data, mask)               \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, mask);                                     \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_msg2(RTE_PACK(filter_no, fmt | (((ext_data) & (mask >> 2U)) << 2U), 2U),  \
                (rte_any32_t)(data1), (rte_any32_t)(data2));                         \
 }
@@ -420,6 +562,7 @@ __STATIC_FORCEINLINE uint32_t _rte_cvt(rte_any32_t value)
 #define INTRTE_EXT_MSG3(fmt, filter_no, data1, data2, data3, ext_data, mask)        \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, mask);                                     \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_msg3(RTE_PACK(filter_no, fmt | (((ext_data) & (mask >> 3U)) << 3U), 3U),  \
                (rte_any32_t)(data1), (rte_any32_t)(data2), (rte_any32_t)(data3));   \
 }
@@ -427,6 +570,7 @@ __STATIC_FORCEINLINE uint32_t _rte_cvt(rte_any32_t value)
 #define INTRTE_EXT_MSG4(fmt, filter_no, data1, data2, data3, data4, ext_data, mask) \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, mask);                                     \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_msg4(RTE_PACK(filter_no, fmt | (((ext_data) & (mask >> 4U)) << 4U), 4U),  \
                (rte_any32_t)(data1), (rte_any32_t)(data2),                          \
                (rte_any32_t)(data3), (rte_any32_t)(data4));                         \
@@ -435,24 +579,28 @@ __STATIC_FORCEINLINE uint32_t _rte_cvt(rte_any32_t value)
 #define RTE_MSGN(fmt, filter_no, address, size)                                     \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 15U);                                      \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_msgn(RTE_PACK(filter_no, fmt, 4U), address, size);                        \
 }
 
 #define RTE_MSGX(fmt, filter_no, address, size)                                     \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 15U);                                      \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_msgx(RTE_PACK_MSGX(filter_no, fmt), address, size);                       \
 }
 
 #define RTE_STRINGN(fmt, filter_no, address, size)                                  \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 15U);                                      \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_stringn(RTE_PACK(filter_no, fmt, 4U), address, size);                     \
 }
 
 #define RTE_STRING(fmt, filter_no, address)                                         \
 {                                                                                   \
     RTE_CHECK_PARAMETERS(filter_no, fmt, 15U);                                      \
+    RTE_IF_MSG_ENABLED(filter_no)                                                   \
     __rte_string(RTE_PACK(filter_no, fmt, 4U), address);                            \
 }
 
@@ -471,6 +619,19 @@ void __rte_msg3(const uint32_t fmt_id, const rte_any32_t data1, const rte_any32_
 void __rte_msg4(const uint32_t fmt_id, const rte_any32_t data1, const rte_any32_t data2,
                 const rte_any32_t data3, const rte_any32_t data4);
 #endif // RTE_USE_INLINE_FUNCTIONS
+#if (RTE_INSTANCES != 0) || (RTE_PRIO_BUFFER_SIZE != 0)
+// Logging to an additional instance or to the priority ring - see RTE_MSG0_I() ... RTE_MSGN_I()
+void __rte_msg0_i(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id);
+void __rte_msg1_i(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id, const rte_any32_t data1);
+void __rte_msg2_i(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id, const rte_any32_t data1,
+                  const rte_any32_t data2);
+void __rte_msg3_i(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id, const rte_any32_t data1,
+                  const rte_any32_t data2, const rte_any32_t data3);
+void __rte_msg4_i(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id, const rte_any32_t data1,
+                  const rte_any32_t data2, const rte_any32_t data3, const rte_any32_t data4);
+void __rte_msgn_i(rtedbg_inst_t * const p_rtedbg, const uint32_t fmt_id,
+                  volatile const void * const address, const uint32_t data_length);
+#endif
 void __rte_msgn(const uint32_t fmt_id, volatile const void * const address, const uint32_t data_length);
 void __rte_msgx(const uint32_t fmt_id, volatile const void * const address, const uint32_t data_length);
 void __rte_string(const uint32_t fmt_id, const char * const address);
@@ -489,8 +650,13 @@ uint32_t rte_get_filter(void);
 
 #if RTE_USE_LONG_TIMESTAMP != 0
 void rte_long_timestamp(void);
+void rte_long_timestamp_check(void);
+#if RTE_LONG_TIMESTAMP_TIMER_IRQ != 0
+void rte_timestamp_timer_irq(void);
+#endif
 #else
 #define rte_long_timestamp()
+#define rte_long_timestamp_check()
 #endif
 
 void rte_timestamp_frequency(const uint32_t new_frequency);
@@ -503,6 +669,90 @@ void rte_restore_filter(void);
 #define rte_restore_filter()
 #endif
 
+#if RTE_RATE_MONITOR != 0
+void rte_rate_monitor(void);
+#else
+#define rte_rate_monitor()
+#endif
+
+#if RTE_RATE_LIMIT != 0
+void rte_rate_limit_init(rte_rate_limit_t * const table, const uint32_t count);
+void rte_rate_limit_refill(void);
+#else
+#define rte_rate_limit_init(table, count)
+#define rte_rate_limit_refill()
+#endif
+
+#if RTE_SUPPRESS_REPEATED != 0
+void rte_flush_repeated(void);
+#else
+#define rte_flush_repeated()
+#endif
+
+#if RTE_DCACHE_SNAPSHOT != 0
+void rte_prepare_snapshot(void);
+void rte_snapshot_poll(void);
+#else
+#define rte_prepare_snapshot()
+#define rte_snapshot_poll()
+#endif
+
+#if RTE_INSTANCES != 0
+void rte_init_i(rtedbg_inst_t * const p_rtedbg, const uint32_t buffer_size,
+                const uint32_t initial_filter_value, const uint32_t init_mode);
+void rte_set_filter_i(rtedbg_inst_t * const p_rtedbg, const uint32_t filter);
+
+/* Logging to an additional instance - the same as RTE_MSG0() ... RTE_MSG4() and RTE_MSGN(),
+ * but with the instance (see RTE_INSTANCE() in the rtedbg_int.h) as the first parameter.
+ * The instance filter is checked at run time.
+ */
+#define RTE_MSG0_I(inst, fmt, filter_no)                                            \
+{                                                                                   \
+    RTE_CHECK_PARAMETERS(filter_no, fmt, 0U);                                       \
+    if (RTE_MSG_COMPILED(filter_no) != 0U)                                          \
+    __rte_msg0_i(inst, RTE_PACK(filter_no, fmt, 0U));                               \
+}
+
+#define RTE_MSG1_I(inst, fmt, filter_no, data1)                                     \
+{                                                                                   \
+    RTE_CHECK_PARAMETERS(filter_no, fmt, 1U);                                       \
+    if (RTE_MSG_COMPILED(filter_no) != 0U)                                          \
+    __rte_msg1_i(inst, RTE_PACK(filter_no, fmt, 1U), (rte_any32_t)(data1));         \
+}
+
+#define RTE_MSG2_I(inst, fmt, filter_no, data1, data2)                              \
+{                                                                                   \
+    RTE_CHECK_PARAMETERS(filter_no, fmt, 3U);                                       \
+    if (RTE_MSG_COMPILED(filter_no) != 0U)                                          \
+    __rte_msg2_i(inst, RTE_PACK(filter_no, fmt, 2U),                                \
+                 (rte_any32_t)(data1), (rte_any32_t)(data2));                       \
+}
+
+#define RTE_MSG3_I(inst, fmt, filter_no, data1, data2, data3)                       \
+{                                                                                   \
+    RTE_CHECK_PARAMETERS(filter_no, fmt, 7U);                                       \
+    if (RTE_MSG_COMPILED(filter_no) != 0U)                                          \
+    __rte_msg3_i(inst, RTE_PACK(filter_no, fmt, 3U),                                \
+                 (rte_any32_t)(data1), (rte_any32_t)(data2), (rte_any32_t)(data3)); \
+}
+
+#define RTE_MSG4_I(inst, fmt, filter_no, data1, data2, data3, data4)                \
+{                                                                                   \
+    RTE_CHECK_PARAMETERS(filter_no, fmt, 15U);                                      \
+    if (RTE_MSG_COMPILED(filter_no) != 0U)                                          \
+    __rte_msg4_i(inst, RTE_PACK(filter_no, fmt, 4U),                                \
+                 (rte_any32_t)(data1), (rte_any32_t)(data2),                        \
+                 (rte_any32_t)(data3), (rte_any32_t)(data4));                       \
+}
+
+#define RTE_MSGN_I(inst, fmt, filter_no, address, size)                             \
+{                                                                                   \
+    RTE_CHECK_PARAMETERS(filter_no, fmt, 15U);                                      \
+    if (RTE_MSG_COMPILED(filter_no) != 0U)                                          \
+    __rte_msgn_i(inst, RTE_PACK(filter_no, fmt, 4U), address, size);               \
+}
+#endif // RTE_INSTANCES != 0
+
 #ifdef __cplusplus
 }
 #endif
@@ -528,10 +778,26 @@ void rte_restore_filter(void);
 #define RTE_STRING(fmt_id, filter, address)
 #define RTE_STRINGN(fmt_id, filter, address, length)
 #define rte_long_timestamp()
+#define rte_long_timestamp_check()
+#define rte_timestamp_timer_irq()
 #define rte_timestamp_frequency(new_frequency)
 #define rte_get_filter() 0
 #define rte_restore_filter()
 #define rte_set_filter(filter)
+#define rte_rate_monitor()
+#define rte_rate_limit_init(table, count)
+#define rte_rate_limit_refill()
+#define rte_flush_repeated()
+#define rte_prepare_snapshot()
+#define rte_snapshot_poll()
+#define rte_init_i(inst, size, filter, mode)
+#define rte_set_filter_i(inst, filter)
+#define RTE_MSG0_I(inst, fmt_id, filter)
+#define RTE_MSG1_I(inst, fmt_id, filter, data1)
+#define RTE_MSG2_I(inst, fmt_id, filter, data1, data2)
+#define RTE_MSG3_I(inst, fmt_id, filter, data1, data2, data3)
+#define RTE_MSG4_I(inst, fmt_id, filter, data1, data2, data3, data4)
+#define RTE_MSGN_I(inst, fmt_id, filter, address, length)
 #define RTE_RESTART_TIMING()
 #endif // RTE_ENABLED != 0
 
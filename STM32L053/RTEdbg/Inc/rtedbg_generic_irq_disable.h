@@ -48,9 +48,9 @@
 #define RTE_RESERVE_SPACE(ptr, buf_idx, size)                        \
 do {                                                                 \
     RTE_ENTER_CRITICAL()                                             \
-    buf_idx = ptr->buf_index;                                        \
-    RTE_LIMIT_INDEX(buf_idx)                                         \
-    ptr->buf_index = buf_idx + (size);                               \
+    buf_idx = RTE_FIELD(ptr, buf_index);                                        \
+    RTE_LIMIT_BUF_INDEX(ptr, buf_idx)                                \
+    RTE_FIELD(ptr, buf_index) = buf_idx + (size);                               \
     RTE_EXIT_CRITICAL()                                              \
 } while(0)
 
@@ -63,19 +63,19 @@ do {                                                                 \
 #define RTE_RESERVE_SPACE(ptr, buf_idx, size)                        \
 do {                                                                 \
     RTE_ENTER_CRITICAL()                                             \
-    buf_idx = ptr->buf_index;                                        \
-    if (ptr->rte_cfg & RTE_SINGLE_SHOT_LOGGING_IS_ACTIVE)            \
+    buf_idx = RTE_FIELD(ptr, buf_index);                                        \
+    if (RTE_FIELD(ptr, rte_cfg) & RTE_SINGLE_SHOT_LOGGING_IS_ACTIVE)            \
     {                                                                \
         /* Check if there is enough space for the complete message */\
-        if ((buf_idx + (size)) >= (uint32_t)(RTE_BUFFER_SIZE))       \
+        if ((buf_idx + (size)) >= RTE_BUF_WORDS(ptr))                \
         {                                                            \
-            RTE_STOP_MESSAGE_LOGGING();                              \
+            RTE_STOP_MESSAGE_LOGGING(ptr);                           \
             RTE_EXIT_CRITICAL()                                      \
             return;        /* Exit the __rte_msg?() function. */     \
         }                                                            \
     }                                                                \
-    RTE_LIMIT_INDEX(buf_idx)                                         \
-    ptr->buf_index = buf_idx + (size);                               \
+    RTE_LIMIT_BUF_INDEX(ptr, buf_idx)                                \
+    RTE_FIELD(ptr, buf_index) = buf_idx + (size);                               \
     RTE_EXIT_CRITICAL()                                              \
 } while(0)
 #endif /* RTE_SINGLE_SHOT_ENABLED == 0 */
@@ -78,11 +78,8 @@ void SysTick_Handler(void)
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
   //++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-  // Log the long timestamp every eight tick periods (8 ms)
-  if ((uwTick & 7u) == 0)
-  {
-      rte_long_timestamp();
-  }
+  // Log the long timestamp only when the short timestamp would become ambiguous
+  rte_long_timestamp_check();
   //++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   /* USER CODE END SysTick_IRQn 1 */
 }
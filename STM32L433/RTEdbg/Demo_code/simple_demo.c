@@ -182,6 +182,15 @@ static void basic_examples(void)
      *       only be performed on unsigned type. However, the code shown above has nothing to do
      *       with functional safety. Its purpose is just to pack the variables for data logging.
      */
+
+    /* Two 16-bit or four 8-bit values can be packed into one word with the pack16_par()
+     * and pack8_par() functions - six values are stored in two DATA words.
+     */
+    int16_t current = -1234;        // [mA]
+    uint16_t voltage = 3300U;       // [mV]
+    RTE_MSG2(MSG2_PACKED_DEMO, F_SINCOS_DEMO,
+        pack16_par((uint16_t)current, voltage),
+        pack8_par((uint8_t)sequence_number, 2U, 30U, 255U))
 }
 
 
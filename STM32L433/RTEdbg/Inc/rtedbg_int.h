@@ -16,6 +16,7 @@
 #ifndef RTEDBG_INT_H
 #define RTEDBG_INT_H
 
+#include <stddef.h>
 #include "rtedbg.h"
 
 // Test if the value is a power of 2 and between 2^2 and 2^31
@@ -32,16 +33,48 @@
   ((n) == (1U <<  3U)) || ((n) == (1U <<  2U))                                                    \
  )
 
-#if RTE_IS_POWER_OF_2((RTE_BUFFER_SIZE))
+#if RTE_BUFFER_SIZE_AT_RUNTIME != 0
+// The buffer size is a power of 2 set by rte_init() - the mask is in the g_rtedbg header
+#define RTE_LIMIT_INDEX(idx)  {idx &= g_rtedbg.index_mask;}
+#define RTE_BUFFER_WORDS      (g_rtedbg.index_mask + 1U)
+// Min. circular buffer size - the largest message must fit into it
+#define RTE_MIN_RUNTIME_BUFFER  ((uint32_t)(RTE_MAX_SUBPACKETS) * 5U)
+#elif RTE_IS_POWER_OF_2((RTE_BUFFER_SIZE))
 // If the buffer size is a power of 2 then the index limiting is a bit faster and code smaller
 #define RTE_LIMIT_INDEX(idx)  {idx &= ((uint32_t)(RTE_BUFFER_SIZE) - 1U);}
+#define RTE_BUFFER_WORDS      ((uint32_t)(RTE_BUFFER_SIZE))
 #else
 #define RTE_LIMIT_INDEX(idx)  {if (idx >= (uint32_t)(RTE_BUFFER_SIZE)) {idx = 0U;}}
+#define RTE_BUFFER_WORDS      ((uint32_t)(RTE_BUFFER_SIZE))
+#endif
+
+/* Data logging structure in the code shared by the g_rtedbg and the additional instances:
+ * RTE_MAIN_RTEDBG selects the g_rtedbg, other values an instance (rtedbg_inst_t).
+ * Each structure is accessed with its own type. The selection is resolved at compile
+ * time in the g_rtedbg logging functions. */
+#define RTE_MAIN_RTEDBG  ((rtedbg_inst_t *)NULL)
+
+#if (RTE_INSTANCES != 0) || (RTE_PRIO_BUFFER_SIZE != 0)
+#define RTE_MAIN_BUFFER(ptr)  ((ptr) == RTE_MAIN_RTEDBG)
+#define RTE_FIELD(ptr, name)  (*(RTE_MAIN_BUFFER(ptr) ? &g_rtedbg.name : &(ptr)->name))
+#define RTE_BUF(ptr)          (RTE_MAIN_BUFFER(ptr) ? &g_rtedbg.buffer[0] : &(ptr)->buffer[0])
+
+/* Index limit and buffer size. The buffer size of an instance is in its header. */
+#define RTE_LIMIT_BUF_INDEX(ptr, idx)                                        \
+    { if (RTE_MAIN_BUFFER(ptr)) RTE_LIMIT_INDEX(idx)                          \
+      else if ((idx) >= ((ptr)->buffer_size - 4U)) {idx = 0U;} else {} }
+#define RTE_BUF_WORDS(ptr)  (RTE_MAIN_BUFFER(ptr) ? RTE_BUFFER_WORDS : ((ptr)->buffer_size - 4U))
+#else
+#define RTE_MAIN_BUFFER(ptr)  1
+#define RTE_FIELD(ptr, name)  (*((void)(ptr), &g_rtedbg.name))
+#define RTE_BUF(ptr)          ((void)(ptr), &g_rtedbg.buffer[0])
+#define RTE_LIMIT_BUF_INDEX(ptr, idx)  RTE_LIMIT_INDEX(idx)
+#define RTE_BUF_WORDS(ptr)  RTE_BUFFER_WORDS
 #endif
 
 #define RTE_TIMESTAMP_MASK  (0xFFFFFFFFU >> (uint32_t)(RTE_FMT_ID_BITS))
 
-#define RTE_HEADER_SIZE  (sizeof(g_rtedbg) - sizeof(g_rtedbg.buffer))
+#define RTE_HEADER_SIZE  (offsetof(rtedbg_t, buffer))
 
 /***********************************************************************************
  * The configuration word defines the embedded system RTEdbg configuration.
@@ -51,7 +84,9 @@
  *        2: 1 = RTE_FILTER_OFF_ENABLED, 0 - filter off not possible
  *        3: 1 = RTE_SINGLE_SHOT_ENABLED, 0 - only post mortem mode possible
  *        4: 1 = RTE_USE_LONG_TIMESTAMP, 0 - long timestamps disabled
- *  5 ..  7: reserved for future use
+ *        5: 1 = RTE_FMT_ID_FILTER, 0 - per format ID filter not used
+ *        6: 1 = priority ring g_rtedbg_prio present (RTE_PRIO_BUFFER_SIZE > 0)
+ *        7: 1 = RTE_PRIO_MIRROR - the priority ring is a copy of the newest messages
  *  8 .. 11: RTE_TIMESTAMP_SHIFT (0 = shift by 1, 1 = shift by 2, etc.)
  * 12 .. 14: RTE_FMT_ID_BITS     (offset 9 => values 0 .. 7 = 9 .. 16)
  *       15: reserved for future use
@@ -61,7 +96,7 @@
  ***********************************************************************************/
 #define RTE_SINGLE_SHOT_LOGGING_IS_ACTIVE  1U   /* Use bit zero to indicate single shot mode = active */
 #define RTE_BUFF_SIZE_RTE_IS_POWER_OF_2    ((RTE_IS_POWER_OF_2(RTE_BUFFER_SIZE)) ? 1U : 0U)
-#if RTE_BUFF_SIZE_RTE_IS_POWER_OF_2
+#if (RTE_BUFF_SIZE_RTE_IS_POWER_OF_2) || (RTE_BUFFER_SIZE_AT_RUNTIME != 0)
 #define RTE_BUFF_SIZE_IS_POWER_OF_2   1U
 #else
 #define RTE_BUFF_SIZE_IS_POWER_OF_2   0U
@@ -74,10 +109,13 @@
         ((uint32_t)RTE_FILTER_OFF_ENABLED                    * (1U <<  2U)) + \
         ((uint32_t)RTE_SINGLE_SHOT_ENABLED                   * (1U <<  3U)) + \
         ((uint32_t)RTE_USE_LONG_TIMESTAMP                    * (1U <<  4U)) + \
+        ((uint32_t)RTE_FMT_ID_FILTER                         * (1U <<  5U)) + \
+        ((((RTE_PRIO_BUFFER_SIZE) != 0U) ? 1U : 0U)          * (1U <<  6U)) + \
+        ((uint32_t)RTE_PRIO_MIRROR                           * (1U <<  7U)) + \
         ((((uint32_t)RTE_TIMESTAMP_SHIFT) - 1U)              * (1U <<  8U)) + \
         ((((uint32_t)RTE_FMT_ID_BITS) - 9U)                  * (1U << 12U)) + \
         ((((uint32_t)RTE_MAX_SUBPACKETS) & 0xFFU)            * (1U << 16U)) + \
-        (((sizeof(g_rtedbg) - sizeof(g_rtedbg.buffer)) / 4U) * (1U << 24U)) + \
+        ((RTE_HEADER_SIZE / 4U)                              * (1U << 24U)) + \
         (RTE_BUFF_SIZE_IS_POWER_OF_2                         * (1U << 31U))   \
     )
 
@@ -126,6 +164,34 @@
 #endif
 #endif
 
+/* Number of 32-bit words in a format ID bitmap (one bit per format ID code) */
+#define RTE_FMT_FILTER_WORDS  (1UL << ((uint32_t)(RTE_FMT_ID_BITS) - 5U))
+
+// Format ID code of a message without the filter number
+#define RTE_FMT_CODE(fmt, shift_bits) \
+    (((fmt) << (shift_bits)) & ((1UL << (uint32_t)(RTE_FMT_ID_BITS)) - 1U))
+
+// Bit 31 of bitmap[0] belongs to format ID 0, bit 30 to format ID 1, etc.
+#define RTE_FMT_BIT_SET(bitmap, code)  ((int32_t)((bitmap)[(code) >> 5U] << ((code) & 31U)) < 0)
+
+#if RTE_FMT_ID_FILTER != 0
+#define RTE_FMT_ID_FILTERED(fmt, shift_bits)  (!RTE_FMT_BIT_SET(g_rte_fmt_filter, RTE_FMT_CODE(fmt, shift_bits)))
+#else
+#define RTE_FMT_ID_FILTERED(fmt, shift_bits)  0U
+#endif
+
+#if RTE_RATE_LIMIT != 0
+#define RTE_RATE_LIMITED(fmt, shift_bits)                                    \
+    (RTE_FMT_BIT_SET(g_rte_rate_limited, RTE_FMT_CODE(fmt, shift_bits)) && \
+     rte_rate_limit_exceeded(RTE_FMT_CODE(fmt, shift_bits)))
+#else
+#define RTE_RATE_LIMITED(fmt, shift_bits)  0U
+#endif
+
+// Message disabled by the per format ID filter or the rate limit
+#define RTE_FMT_ID_DISABLED(fmt, shift_bits) \
+    (RTE_FMT_ID_FILTERED(fmt, shift_bits) || RTE_RATE_LIMITED(fmt, shift_bits))
+
 // Empty optimization definitions if the rtedbg.c file optimization will be set in
 // the IDE (or makefile) or inherited from the complete project setup.
 #if !defined RTE_OPTIMIZE_CODE
@@ -144,6 +210,33 @@
 #define RTE_OPTIM_LARGE
 #endif
 
+// Empty definitions if the data logging code and variables are not placed in fast memory.
+#if !defined RTE_FAST_CODE
+#define RTE_FAST_CODE
+#endif
+
+#if !defined RTE_FAST_DATA
+#define RTE_FAST_DATA
+#endif
+
+#if !defined RTE_PRIO_RAM
+#define RTE_PRIO_RAM  RTE_DBG_RAM
+#endif
+
+#if !defined RTE_FMT_FILTER_RAM
+#define RTE_FMT_FILTER_RAM  RTE_DBG_RAM  // Must not be cleared by the startup code
+#endif
+
+#if !defined RTE_ERASE_SEGMENT_HOOK
+#define RTE_ERASE_SEGMENT_HOOK()
+#endif
+
+#if (RTE_DCACHE_SNAPSHOT != 0) && (!defined RTE_DCACHE_CLEAN) && (defined __DCACHE_PRESENT)
+#if __DCACHE_PRESENT == 1U
+#define RTE_DCACHE_CLEAN(address, size)  SCB_CleanDCache_by_Addr((void *)(address), (int32_t)(size))
+#endif
+#endif
+
 
 /*********************************************************************************
  * @brief Data structure for rtedbg library data logging.
@@ -152,7 +245,7 @@
  *       RTEdbg library data logging functions.
  *********************************************************************************/
 
-typedef struct
+struct rtedbg
 {
     //---- g_rtedbg structure header start -----------------------------------
     volatile uint32_t buf_index;
@@ -178,18 +271,131 @@ typedef struct
         /*!< The size of the circular data logging buffer  (RTE_BUFFER_SIZE + 4).
              It includes four additional words at the end of the buffer to speed up data logging.
          */
+#if RTE_BUFFER_SIZE_AT_RUNTIME != 0
+    uint32_t index_mask;
+        /*!< Circular buffer size - 1. The size is a power of 2 set by rte_init(). */
+#endif
+#if RTE_RESUME_CHECK != 0
+    uint32_t header_check;
+        /*!< Check word of the rte_cfg, timestamp_frequency, buffer_size and index_mask
+         *   values. A mismatch after a reset forces the initialization in rte_init().
+         */
+#endif
     //---- g_rtedbg structure header end -----------------------------------
 
+#if RTE_BUFFER_SIZE_AT_RUNTIME != 0
+    uint32_t buffer[];
+        /*!< Circular data logging buffer + 4 word trailer (size set at run time). */
+#else
     uint32_t buffer[(uint32_t)(RTE_BUFFER_SIZE) + 4U];
+#endif
         /*!< Circular data logging buffer + 4 word trailer. */
         /* @note The additional four words make it possible to speed up the execution of
          * the code, since the check to see if the index is already at the end of the
          * buffer is performed only once per data subpacket.
          */
-} rtedbg_t;
+};
 
 extern rtedbg_t g_rtedbg;   // Global data logging structure
 
+#if (RTE_ENABLED != 0) && (RTE_INLINE_FILTER_CHECK != 0)
+// The inline message filter check in rtedbg.h reads the filter as the second header word
+static_assert(offsetof(rtedbg_t, filter) == 4U, "RTE_FILTER_VALUE() does not match rtedbg_t.");
+#endif
+
+/*********************************************************************************
+ * @brief Additional data logging instance (see RTE_INSTANCES) or the priority ring.
+ *        The header is the same as the g_rtedbg header (see the field descriptions
+ *        above), so that the host software can decode each instance in the same way
+ *        as g_rtedbg. The buffer size is defined at run time - the index wraps to zero
+ *        at the end of the buffer (bit 31 of rte_cfg is 0). The messages are logged
+ *        with the same functions as to g_rtedbg.
+ *        Define the storage with RTE_INSTANCE_STORAGE(), e.g.:
+ *          static RTE_INSTANCE_STORAGE(1024U) capture RTE_DBG_RAM;
+ *          rte_init_i(RTE_INSTANCE(capture), 1024U, 0xFFFFFFFFU, RTE_CONTINUE_LOGGING);
+ *          RTE_MSG1_I(RTE_INSTANCE(capture), MSG1_ADC_VALUE, F_ADC, value)
+ *********************************************************************************/
+struct rtedbg_inst
+{
+    volatile uint32_t buf_index;
+    volatile uint32_t filter;
+    uint32_t rte_cfg;
+    uint32_t timestamp_frequency;
+    uint32_t filter_copy;
+    uint32_t buffer_size;               /*!< Circular buffer size + 4 */
+#if RTE_BUFFER_SIZE_AT_RUNTIME != 0
+    uint32_t index_mask;                /*!< Not used - always 0 */
+#endif
+#if RTE_RESUME_CHECK != 0
+    uint32_t header_check;
+#endif
+    uint32_t buffer[];                  /*!< Circular buffer + 4 word trailer */
+};
+
+static_assert(offsetof(rtedbg_inst_t, buffer) == RTE_HEADER_SIZE, "rtedbg_inst_t header does not match rtedbg_t.");
+
+// Storage for an instance with a circular buffer of 'size' 32-bit words
+#define RTE_INSTANCE_STORAGE(size)                                                 \
+    union                                                                          \
+    {                                                                              \
+        rtedbg_inst_t inst;                                                        \
+        uint32_t words[((RTE_HEADER_SIZE) / 4U) + (uint32_t)(size) + 4U];          \
+    }
+
+// Pointer to the instance defined with RTE_INSTANCE_STORAGE()
+#define RTE_INSTANCE(storage)  (&(storage).inst)
+
+#if RTE_PRIO_BUFFER_SIZE != 0
+/*********************************************************************************
+ * @brief Priority ring for the messages of the filter groups selected with the
+ *        RTE_PRIO_FILTER_MASK. These messages are logged to this ring only and can
+ *        not be overwritten by the messages of other groups. The host software decodes
+ *        both structures and merges the messages into one timeline according to their
+ *        timestamps. The filter field contains the RTE_PRIO_FILTER_MASK value.
+ *        If RTE_PRIO_MIRROR != 0, the messages are logged to both g_rtedbg and the ring.
+ *        The ring is an rtedbg_inst_t object (RTE_PRIO_RING) in the rtedbg_prio_t storage.
+ *********************************************************************************/
+typedef RTE_INSTANCE_STORAGE(RTE_PRIO_BUFFER_SIZE) rtedbg_prio_t;
+
+extern rtedbg_prio_t g_rtedbg_prio;     // Priority ring
+#define RTE_PRIO_RING  RTE_INSTANCE(g_rtedbg_prio)
+
+// Message of a filter group that is logged to the priority ring
+#define RTE_PRIO_MSG(fmt, shift_bits) \
+    (((int32_t)((uint32_t)(RTE_PRIO_FILTER_MASK) << ((fmt) >> ((uint32_t)(RTE_FMT_ID_BITS) - (shift_bits))))) < 0)
+#else
+#define RTE_PRIO_MSG(fmt, shift_bits)  0U
+#endif
+
+#if RTE_FMT_ID_FILTER != 0
+extern uint32_t g_rte_fmt_filter[RTE_FMT_FILTER_WORDS];   // Per format ID message filter
+#endif
+
+#if RTE_RATE_LIMIT != 0
+extern uint32_t g_rte_rate_limited[RTE_FMT_FILTER_WORDS]; // Format IDs with a rate limit
+uint32_t rte_rate_limit_exceeded(const uint32_t fmt_code);
+#endif
+
+#if RTE_DCACHE_SNAPSHOT != 0
+extern volatile uint32_t g_rte_snapshot_request;    // Snapshot request flag (set by the host)
+#endif
+
+#if RTE_USE_LONG_TIMESTAMP != 0
+/*********************************************************************************
+ * @brief 64-bit extension of the timestamp counter for the long timestamp.
+ *        Timestamps are timer counter values aligned to bit 31.
+ *********************************************************************************/
+typedef struct
+{
+    uint32_t l;         // Lower 32 bits of the 64-bit timestamp
+    uint32_t h;         // Upper 32 bits of the 64-bit timestamp
+    uint32_t half;      // Short timestamp half period in which the last long timestamp was logged
+    uint32_t last_msg;  // Timestamp of the last message (used if RTE_LONG_TIMESTAMP_IN_MSG = 1)
+} rte_tstamp64_t;
+
+extern rte_tstamp64_t g_rte_tstamp;
+#endif
+
 /*********************************************************************************
  * @brief Union defined to move the top bit of 32-bit data words into an FMT word
  *        that combines bit 31 of the DATA words with the format ID and timestamp.
@@ -206,15 +412,24 @@ typedef union
 
 
 #if defined RTE_STOP_SINGLE_SHOT_AT_FIRST_TOO_LARGE_MSG
-#define RTE_STOP_MESSAGE_LOGGING()  ptr->filter = 0
+#define RTE_STOP_MESSAGE_LOGGING(ptr)  RTE_FIELD(ptr, filter) = 0U
 #else
-#define RTE_STOP_MESSAGE_LOGGING()
+#define RTE_STOP_MESSAGE_LOGGING(ptr)
 #endif
 
 #ifndef RTE_DATA_MEMORY_BARRIER
 #define RTE_DATA_MEMORY_BARRIER()
 #endif
 
+/* Critical section for the code that is not in the logging fast path (e.g. the long
+ * timestamp). Define both macros in the rtedbg_config.h if the default ARM Cortex-M
+ * version is not appropriate (e.g. for unprivileged code or multi-core systems).
+ */
+#if !defined RTE_ENTER_CRITICAL
+#define RTE_ENTER_CRITICAL()  uint32_t irq_tmp = __get_PRIMASK(); __disable_irq();
+#define RTE_EXIT_CRITICAL()   if (irq_tmp == 0U) { __enable_irq(); }
+#endif
+
 #if (RTE_TIMESTAMP_SHIFT) < 1U
 #error "The timestamp shift value must be one or more."
 #endif
@@ -26,15 +26,12 @@ extern "C" {
 
 #define RTE_TIMESTAMP_COUNTER_BITS  32U  // Number of timer counter bits available for the timestamp
 
-#if !defined RTE_USE_INLINE_FUNCTIONS
-#if RTE_USE_LONG_TIMESTAMP != 0
-struct _tstamp64
-{
-    uint32_t l;    // Lower 32 bits of the 64-bit timestamp
-    uint32_t h;    // Upper 32 bits of the 64-bit timestamp
-} t_stamp;
-#endif // RTE_USE_LONG_TIMESTAMP != 0
+#if (RTE_USE_LONG_TIMESTAMP != 0) && (RTE_LONG_TIMESTAMP_TIMER_IRQ != 0)
+/* Compare interrupt period (half period of the short timestamp in timer counter ticks) */
+#define RTE_LONG_TSTAMP_IRQ_PERIOD  (1UL << ((30U - (uint32_t)(RTE_FMT_ID_BITS)) + (RTE_TIMESTAMP_SHIFT)))
+#endif
 
+#if !defined RTE_USE_INLINE_FUNCTIONS
 
 /***
  * @brief Initialize the peripheral for the timestamp counter.
@@ -52,14 +49,16 @@ __STATIC_FORCEINLINE void rte_init_timestamp_counter(void)
 
     // Configure only the registers that require non-default values.
     TIM2->PSC = (RTE_TIMESTAMP_PRESCALER) - 1;
+#if (RTE_USE_LONG_TIMESTAMP != 0) && (RTE_LONG_TIMESTAMP_TIMER_IRQ != 0)
+    TIM2->CCR1 = RTE_LONG_TSTAMP_IRQ_PERIOD;
+    TIM2->DIER = TIM_DIER_CC1IE;    // Compare interrupt drives the long timestamp
+    NVIC_ClearPendingIRQ(TIM2_IRQn);
+    NVIC_EnableIRQ(TIM2_IRQn);
+#endif
     TIM2->CR1 = TIM_CR1_CEN;        // Enable the timer counter
 #if (RTE_TIMESTAMP_PRESCALER) != 1U
     TIM2->EGR = TIM_EGR_UG;         // Reload the prescaler with the new value
 #endif
-
-#if RTE_USE_LONG_TIMESTAMP != 0
-    t_stamp.l = t_stamp.h = 0;      // Initialize the long timestamp to zero
-#endif
 }
 #endif  // !defined RTE_USE_INLINE_FUNCTIONS
 
@@ -76,38 +75,28 @@ __STATIC_FORCEINLINE uint32_t rte_get_timestamp(void)
 }
 
 
-#if (RTE_USE_LONG_TIMESTAMP != 0) && (!defined RTE_USE_INLINE_FUNCTIONS)
-
+#if (RTE_USE_LONG_TIMESTAMP != 0) && (RTE_LONG_TIMESTAMP_TIMER_IRQ != 0) && (!defined RTE_USE_INLINE_FUNCTIONS)
 /*********************************************************************************
- * @brief  Writes a message with a long timestamp to the buffer.
- *         The lower bits of the timestamp are included in the message words with the
- *         format ID. Only the higher 32 bits are transmitted in the message's
- *         data part.
+ * @brief  TIM2 capture/compare 1 interrupt handling - call it from TIM2_IRQHandler().
+ *         The interrupt is triggered once per half period of the short timestamp and
+ *         the long timestamp is logged only then. Periodic calls of the function
+ *         rte_long_timestamp_check() from e.g. SysTick_Handler() are not needed.
  *
- * @note    This function is not reentrant. Typically, calls should be made from a
- *          single section of the program that is periodically executed - e.g.
- *          from a timer interrupt routine.
+ * @note   Set the TIM2 interrupt priority according to the project requirements.
+ *         Interrupt latency up to a half period of the short timestamp is tolerated.
  *********************************************************************************/
 
-RTE_OPTIM_SIZE void rte_long_timestamp(void)
+RTE_OPTIM_SIZE void rte_timestamp_timer_irq(void)
 {
-    uint32_t timestamp =
-        (uint32_t)(rte_get_timestamp() << (32U - (RTE_TIMESTAMP_COUNTER_BITS)));
-
-    if (t_stamp.l > timestamp)    // Has the counter rolled over?
+    if ((TIM2->SR & TIM_SR_CC1IF) != 0U)
     {
-        t_stamp.h++;
+        TIM2->SR = ~TIM_SR_CC1IF;   // Clear the interrupt flag (rc_w0 bits)
+        TIM2->CCR1 += RTE_LONG_TSTAMP_IRQ_PERIOD;
+        rte_long_timestamp_check();
     }
-
-    t_stamp.l = timestamp;
-    uint64_t timestamp_64 = (uint64_t)timestamp | ((uint64_t)t_stamp.h << 32U);
-    uint32_t long_t_stamp = (uint32_t)(timestamp_64 >>
-                                ((32U - ((uint32_t)(RTE_FMT_ID_BITS))) - 1U + (RTE_TIMESTAMP_SHIFT) +
-                                 (32U - (RTE_TIMESTAMP_COUNTER_BITS))));
-    RTE_MSG1(MSG1_LONG_TIMESTAMP, F_SYSTEM, long_t_stamp);
 }
+#endif
 
-#endif // (RTE_USE_LONG_TIMESTAMP != 0) && (!defined RTE_USE_INLINE_FUNCTIONS)
 
 #ifdef __cplusplus
 }
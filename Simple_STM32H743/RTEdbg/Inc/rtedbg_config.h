@@ -58,6 +58,15 @@ extern "C" {
     * This value must be the same as the RTEmsg command line parameter -N=value.
     * The value should not be larger than necessary to have more bits for the timestamp.
     * Number of bits available for the timestamp = 32 - RTE_FMT_ID_BITS - 1
+    * The format ID space used by a message depends on the number of its DATA words
+    * (e.g. 1 for RTE_MSG0, 8 for RTE_MSG3 and 16 for RTE_MSG4 and RTE_MSGN). If a
+    * project needs many format IDs and the timestamp period becomes too short for the
+    * frequent messages:
+    *  - log rarely used messages with a common format ID and a message number in the
+    *    first DATA word - the text can be selected with %[8u]{...|...}Y,
+    *  - replace the rarely used RTE_MSG4 and RTE_MSGN messages with RTE_MSG0..3,
+    *  - enable RTE_LONG_TIMESTAMP_IN_MSG so that a long timestamp is logged only when
+    *    the time since the previous message is too long.
     */
 
 #define RTE_BUFFER_SIZE                2048
@@ -66,6 +75,31 @@ extern "C" {
    * a bit faster and the logging functions are also smaller.
    */
 
+#define RTE_BUFFER_SIZE_AT_RUNTIME        0
+  /* 1 - The circular buffer size is set by rte_init() from the RTE_GET_BUFFER_SIZE() value,
+   *     so that product variants with different RAM maps can use the same library
+   *     configuration. The size is the largest power of 2 that fits into the available
+   *     space and the index mask is stored in the g_rtedbg header (the index limiting is
+   *     a single AND as for a constant power of 2 size). The g_rtedbg symbol must be
+   *     defined at the start of the reserved memory - e.g. in the linker script:
+   *       g_rtedbg = ORIGIN(RAM_D2);  __rte_area_end = ORIGIN(RAM_D2) + LENGTH(RAM_D2);
+   *     and RTE_GET_BUFFER_SIZE() must return the number of 32-bit words available for
+   *     the circular buffer (see the example below - declare: extern uint32_t __rte_area_end;).
+   *     If the circular buffer would be smaller than the largest message (RTE_MAX_SUBPACKETS
+   *     * 5 words), rte_init() leaves the message logging disabled (filter = 0).
+   *     RTE_BUFFER_SIZE is then used for the compile time checks only.
+   * 0 - The buffer size is defined by RTE_BUFFER_SIZE.
+   */
+// #define RTE_GET_BUFFER_SIZE()  (((uint32_t)&__rte_area_end - (uint32_t)&g_rtedbg.buffer[0]) / 4U)
+
+#define RTE_ERASE_SEGMENT_SIZE            0U
+  /* Number of 32-bit words erased at a time by rte_init() and rte_init_i().
+   * RTE_ERASE_SEGMENT_HOOK() is called after each segment - e.g. to refresh the watchdog
+   * while a multi-megabyte buffer in external SDRAM or PSRAM is erased (see the example
+   * below). 0 - the buffer is erased at once.
+   */
+// #define RTE_ERASE_SEGMENT_HOOK()  HAL_IWDG_Refresh(&hiwdg)
+
 #define RTE_MAX_SUBPACKETS              16
   /* The maximum number of data subpackets in a message determines the maximum message size.
    * Length of a subpacket is four 32-bit words plus one FMT word.
@@ -119,10 +153,28 @@ extern "C" {
    */
 
 #define RTE_USE_LONG_TIMESTAMP            1
-  /* 1 - Long timestamp used in the project - rte_long_timestamp() function enabled.
+  /* 1 - Long timestamp used in the project - rte_long_timestamp() and
+   *     rte_long_timestamp_check() functions enabled.
    * 0 - Long timestamp not used (only relative times between messages are logged).
    */
 
+#define RTE_LONG_TIMESTAMP_TIMER_IRQ      0
+  /* 1 - The long timestamp is driven by the compare interrupt of the timestamp timer.
+   *     Call rte_timestamp_timer_irq() from the timer interrupt handler. Available for
+   *     the STM32H7 and STM32L4 TIM2 timestamp drivers only.
+   * 0 - Call rte_long_timestamp_check() periodically - at least once per half period
+   *     of the short timestamp. A message is logged only when the half period changes.
+   */
+
+#define RTE_LONG_TIMESTAMP_IN_MSG         0
+  /* 1 - The logging functions log the long timestamp before a message automatically if
+   *     the time since the previous message exceeds half of the short timestamp period.
+   *     Periodic calls of rte_long_timestamp_check() are needed only if the time between
+   *     messages can be longer than the timestamp counter period. Requires
+   *     RTE_DELAYED_TSTAMP_READ = 0. Adds a few instructions to each logging function.
+   * 0 - The long timestamp is logged only by rte_long_timestamp...() function calls.
+   */
+
 #define RTE_SINGLE_SHOT_ENABLED           0
   /* 1 - Both post-mortem and single shot logging available to the programmer.
    *     Which logging method will be used is defined by the rte_init() function parameter.
@@ -135,6 +187,162 @@ extern "C" {
    *     testing/debugging.
    */
 
+#define RTE_FMT_ID_FILTER                 0
+  /* 1 - Per format ID message filter enabled in addition to the 32 filter groups.
+   *     The g_rte_fmt_filter[] array contains one bit per format ID code (bit 31 of
+   *     the first word = format ID 0). rte_init() enables all of them unless logging
+   *     continues with an unchanged configuration (RTE_CONTINUE_LOGGING). The host can
+   *     disable individual messages at run time by clearing their bits. Messages that
+   *     use more than one code (EXT_MSG..) have one bit per extended data value.
+   *     Size: 2^RTE_FMT_ID_BITS / 8 bytes of RAM. The array is placed with RTE_DBG_RAM
+   *     (not cleared at startup) unless RTE_FMT_FILTER_RAM defines another section.
+   * 0 - Only the 32 message filter groups are available.
+   */
+
+#define RTE_INLINE_FILTER_CHECK           0
+  /* 1 - The RTE_MSG.. macros check the message filter group before the logging function
+   *     is called. A disabled message costs only a load, a bit test and a branch, but
+   *     each enabled call site is a few bytes larger. The arguments of disabled messages
+   *     are not evaluated - do not use arguments with side effects (e.g. i++).
+   * 0 - The message filter is checked in the logging functions only.
+   */
+
+#define RTE_COMPILE_FILTER_MASK           0xFFFFFFFFUL
+  /* Compile-time message filter - bit 31 = filter #0, bit 30 = filter #1, etc. Logging of
+   * the filter groups with bit value 0 is removed from the code (no code and no execution
+   * time). Individual source files can exclude additional groups by defining
+   * RTE_MODULE_FILTER_MASK before including rtedbg.h. Filter #0 is always compiled in.
+   * Example: debug builds 0xFFFFFFFFUL, release builds 0xE0000000UL (groups #0..#2 only).
+   */
+
+#define RTE_RATE_MONITOR                  0
+  /* 1 - Adaptive load shedding with rte_rate_monitor() enabled. The function must be
+   *     called periodically. It disables the lowest priority filter groups from the
+   *     RTE_RATE_SHED_MASK one by one while more than RTE_RATE_BUDGET words are logged
+   *     per call period and re-enables them one by one after the rate stays below half
+   *     of the budget for RTE_RATE_RESTORE_WINDOWS call periods.
+   *     This keeps the history of important messages in the buffer during message floods.
+   * 0 - Load shedding disabled.
+   */
+#define RTE_RATE_BUDGET                   (RTE_BUFFER_SIZE / 16U)
+  /* Maximum number of words logged per rte_rate_monitor() call period. */
+#define RTE_RATE_SHED_MASK                0x0000FFFFUL
+  /* Filter groups that may be disabled by rte_rate_monitor() - e.g. filters #16 to #31. */
+#define RTE_RATE_RESTORE_WINDOWS          10U
+  /* Number of quiet call periods before the next filter group is re-enabled. */
+
+#define RTE_RATE_LIMIT                    0
+  /* 1 - Per format ID rate limits enabled. Register a table of format IDs with their
+   *     maximum number of messages per period with rte_rate_limit_init() and call
+   *     rte_rate_limit_refill() once per period. Messages over the limit are discarded
+   *     and their number is logged at the refill. Messages without a limit cost one
+   *     more load and bit test. Uses 2^RTE_FMT_ID_BITS / 8 bytes of RAM.
+   * 0 - Rate limits disabled.
+   */
+
+#define RTE_SUPPRESS_REPEATED             0
+  /* 1 - A message logged with RTE_MSG0..4 or RTE_EXT_MSG0..4 that is identical to the
+   *     previous one with the same format ID (same data) is only counted. The
+   *     MSG4_MSG_REPEATED message with the format ID, the number of repetitions and the
+   *     timestamps of the first and last one is logged before the next different message
+   *     with this format ID or by rte_flush_repeated().
+   *     Call rte_flush_repeated() before the message logging is stopped with
+   *     rte_set_filter(0U) - e.g. in a fault handler or before the data transfer to the
+   *     host. The counted repetitions are lost otherwise.
+   *     The table slot is compared and updated with interrupts disabled (PRIMASK) in each
+   *     RTE_MSG0..4 call. This adds a short critical section (about 20 instructions) to
+   *     the otherwise lock-free logging functions - the interrupt latency increases
+   *     accordingly.
+   *     Not available if RTE_MINIMIZED_CODE_SIZE != 0.
+   * 0 - All messages are logged.
+   */
+
+#define RTE_REPEAT_TABLE_SIZE             4U
+  /* Number of format IDs (power of 2) whose last message is kept for RTE_SUPPRESS_REPEATED.
+   * Interleaved messages of different format IDs are suppressed unless they share a table
+   * slot (packed format ID + number of data words). Size: 32 bytes of RAM per entry.
+   */
+
+#define RTE_PRIO_BUFFER_SIZE              0U
+  /* Size of the priority ring g_rtedbg_prio (number of 32-bit words, min. 4 x the largest
+   * message size). 0 - priority ring disabled.
+   * Messages of the filter groups selected with RTE_PRIO_FILTER_MASK are logged to this
+   * ring instead of the g_rtedbg buffer and can not be overwritten by frequent messages
+   * of other groups (e.g. reset causes, errors and exception dumps). Long timestamps are
+   * always logged to both (also if F_SYSTEM is not in RTE_PRIO_FILTER_MASK). The host
+   * software decodes both structures and merges the messages into one timeline. The
+   * RTE_STRING messages are logged like RTE_MSGN (to the priority ring if their filter
+   * group is selected). The RTE_MSGX messages are always logged to the g_rtedbg buffer.
+   * Define RTE_PRIO_RAM to place the ring in another memory section.
+   * Requires RTE_MINIMIZED_CODE_SIZE = 0 and RTE_MSG_FILTERING_ENABLED = 1.
+   */
+
+#define RTE_PRIO_FILTER_MASK              0x80000000UL
+  /* Filter groups logged to the priority ring - bit 31 = filter #0 (F_SYSTEM),
+   * bit 30 = filter #1, etc.
+   */
+
+#define RTE_PRIO_MIRROR                   0
+  /* 1 - The priority ring is a "black box" mirror. Messages of the RTE_PRIO_FILTER_MASK
+   *     groups are logged to both g_rtedbg and the priority ring (RTE_PRIO_FILTER_MASK =
+   *     0xFFFFFFFF - newest RTE_PRIO_BUFFER_SIZE words of all RTE_MSG0..4 and RTE_MSGN
+   *     messages). The ring is not erased by rte_init() unless the configuration has
+   *     changed. Place it in the battery backed SRAM with RTE_PRIO_RAM to keep the last
+   *     messages after a power loss, e.g. for the STM32H7:
+   *       #define RTE_PRIO_RAM  __attribute__((section("RTEBKPRAM")))
+   *       GCC linker script: .rte_bkp (NOLOAD) : { *(RTEBKPRAM) } >BKPSRAM
+   *                          (BKPSRAM: ORIGIN = 0x38800000, LENGTH = 4K)
+   *     Enable the backup domain write access and backup regulator (HAL_PWR_EnableBkUpAccess(),
+   *     HAL_PWREx_EnableBkUpReg()) and the BKPRAM clock before rte_init(). The ring must be
+   *     in a non-cacheable or write-through MPU region - the data in the D-cache is lost
+   *     at power loss. The last message may be incomplete if the power failed while it
+   *     was being written. The host software uses the ring when g_rtedbg is not available
+   *     and skips the messages already present in g_rtedbg (the same timestamp and data).
+   * 0 - The messages of the selected groups are logged to the priority ring only.
+   */
+
+#define RTE_INSTANCES                     0
+  /* 1 - Additional data logging instances enabled (e.g. a fast signal capture buffer in
+   *     DTCM and a slow event buffer in backup SRAM). Each instance has its own buffer
+   *     size, filter and logging mode. Define the storage with RTE_INSTANCE_STORAGE(),
+   *     initialize it with rte_init_i(RTE_INSTANCE(storage), ...) and log with the
+   *     RTE_MSG0_I() ... RTE_MSG4_I() and RTE_MSGN_I() macros. The messages are written by
+   *     the same code as the g_rtedbg ones (lock-free buffer space reservation). The
+   *     instance header has the same layout as the g_rtedbg header - transfer and decode
+   *     each instance in the same way as g_rtedbg.
+   *     The default instance g_rtedbg and the RTE_MSG.. macros are not affected.
+   *     Requires RTE_MINIMIZED_CODE_SIZE = 0.
+   * 0 - Only the g_rtedbg instance is available.
+   */
+
+#define RTE_DCACHE_SNAPSHOT               0
+  /* 1 - The g_rtedbg structure may be placed in write-back cacheable memory (e.g. RAM_D1
+   *     of a Cortex-M7 with the data cache enabled). The debug probe reads the RAM and not
+   *     the data cache - call rte_prepare_snapshot() before the buffer is transferred to
+   *     the host. Only the cache lines written since the previous call are cleaned.
+   *     Alternatively, the host software sets g_rte_snapshot_request to non-zero and waits
+   *     until the firmware clears it in rte_snapshot_poll() (called e.g. from the idle loop).
+   *     The g_rte_snapshot_request variable must be in non-cacheable memory (e.g. DTCM).
+   *     RTE_DCACHE_CLEAN(address, size) is defined in the rtedbg_int.h for CMSIS cores
+   *     with a data cache - define it here for other cores.
+   * 0 - The g_rtedbg structure is in non-cacheable memory or the data cache is disabled.
+   */
+
+#define RTE_RESUME_CHECK                  0
+  /* 1 - rte_init() checks the g_rtedbg header and buffer index when the post-mortem logging
+   *     continues after a reset (RTE_CONTINUE_LOGGING). A header check word (one additional
+   *     header word) covers the values set by rte_init() - the buffer is initialized if
+   *     e.g. rte_cfg or buffer_size has been corrupted. The words of a message that was
+   *     interrupted by the reset are erased (max. 5 words before the buffer index) and an
+   *     invalid buffer index is set to zero - the logged data is kept. The reset boundary
+   *     is marked with the MSG2_LOG_RESUMED message (F_SYSTEM filter group).
+   *     Limits: only the last unfinished subpacket is erased. An unfinished message
+   *     followed by a completed message of a higher priority task or interrupt, reserved
+   *     but never written words whose old content ends with an FMT word, and the earlier
+   *     subpackets of an unfinished long message are kept (see rte_repair_tail()).
+   * 0 - The buffer content is used as it is if the configuration word matches.
+   */
+
 #define RTE_DISCARD_TOO_LONG_MESSAGES     1
   /* 1 - Discard messages that are longer than the maximum allowed.
    * 0 - Shorten messages that are too long to the maximum size.
@@ -186,6 +394,33 @@ extern "C" {
     */
 #endif
 
+/*-----------------------------------------------------------------------------
+ * Placement of the data logging hot path in fast memory - e.g. ITCM/DTCM of a Cortex-M7
+ * if the program runs from the flash memory with wait states. Leave the macros undefined
+ * if the complete program already runs from fast memory.
+ *   RTE_FAST_CODE - section of the __rte_msg0() ... __rte_msg4(), __rte_msgn(), __rte_msgx(),
+ *                   __rte_string(n)(), __rte_msg0_i() ... __rte_msgn_i() functions and the
+ *                   functions they call (the buffer space reservation code is inlined in
+ *                   these functions)
+ *   RTE_FAST_DATA - section of the library variables used by these functions (format ID
+ *                   filter, rate limit, repeated message and long timestamp data)
+ * The g_rtedbg header can not be separated from the circular buffer. Place the complete
+ * g_rtedbg structure with RTE_DBG_RAM (e.g. header and buffer in DTCM if it is large enough).
+ * Linker script examples:
+ *   GCC:  .rte_fast_code : { . = ALIGN(4); *(RTEFASTCODE) . = ALIGN(4); } >ITCMRAM AT> FLASH
+ *         .rte_fast_data : { . = ALIGN(4); *(RTEFASTDATA) . = ALIGN(4); } >DTCMRAM AT> FLASH
+ *         Copy both sections from LOADADDR() to their addresses in the startup code.
+ *   IAR:  initialize by copy { readwrite, section RTEFASTCODE };
+ *         place in ITCMRAM_region { section RTEFASTCODE };
+ *         place in RAM_region { section RTEFASTDATA };
+ *   Keil: RW_ITCM 0x00000000 0x00010000 { *(RTEFASTCODE) }
+ *         RW_DTCM 0x20000000 0x00020000 { *(RTEFASTDATA) .ANY (+RW +ZI) }
+ *-----------------------------------------------------------------------------*/
+#if 0   // Example for the GCC, IAR and ARM compilers
+#define RTE_FAST_CODE  __attribute__((section("RTEFASTCODE")))
+#define RTE_FAST_DATA  __attribute__((section("RTEFASTDATA")))
+#endif
+
 /*---------------------------------------------------------------------------
  * Code optimization parameters for the functions in the rtedbg.c file.
  *
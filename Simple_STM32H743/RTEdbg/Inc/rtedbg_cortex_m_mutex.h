@@ -46,11 +46,11 @@ do {                                                                        \
     uint32_t new_index;                                                     \
     do                                                                      \
     {                                                                       \
-        buf_idx = __LDREXW(&ptr->buf_index);                                \
-        RTE_LIMIT_INDEX(buf_idx)                                            \
+        buf_idx = __LDREXW(&RTE_FIELD(ptr, buf_index));                                \
+        RTE_LIMIT_BUF_INDEX(ptr, buf_idx)                                   \
         new_index = buf_idx + (size);                                       \
     }                                                                       \
-    while (__STREXW(new_index, &ptr->buf_index) != 0);                      \
+    while (__STREXW(new_index, &RTE_FIELD(ptr, buf_index)) != 0);                      \
 } while(0)
 
 #else   /* RTE_SINGLE_SHOT_ENABLED == 1 */
@@ -64,21 +64,21 @@ do {                                                                        \
     uint32_t new_index;                                                     \
     do                                                                      \
     {                                                                       \
-        buf_idx = __LDREXW(&ptr->buf_index);                                \
-        if (ptr->rte_cfg & RTE_SINGLE_SHOT_LOGGING_IS_ACTIVE)               \
+        buf_idx = __LDREXW(&RTE_FIELD(ptr, buf_index));                                \
+        if (RTE_FIELD(ptr, rte_cfg) & RTE_SINGLE_SHOT_LOGGING_IS_ACTIVE)               \
         {                                                                   \
             /* Check if there is enough space for the complete message */   \
-            if ((buf_idx + (size)) >= (uint32_t)(RTE_BUFFER_SIZE))          \
+            if ((buf_idx + (size)) >= RTE_BUF_WORDS(ptr))                   \
             {                                                               \
-               RTE_STOP_MESSAGE_LOGGING();                                  \
+               RTE_STOP_MESSAGE_LOGGING(ptr);                               \
                __CLREX();                                                   \
                return;           /* Exit the __rte_msg function. */         \
             }                                                               \
         }                                                                   \
-        RTE_LIMIT_INDEX(buf_idx)                                            \
+        RTE_LIMIT_BUF_INDEX(ptr, buf_idx)                                   \
         new_index = buf_idx + (size);                                       \
     }                                                                       \
-    while (__STREXW(new_index, &ptr->buf_index) != 0);                      \
+    while (__STREXW(new_index, &RTE_FIELD(ptr, buf_index)) != 0);                      \
 } while(0)
 
 #endif /* RTE_SINGLE_SHOT_ENABLED == 0 */
@@ -143,7 +143,10 @@ void __NO_RETURN __USED main_exception_handler(const uint32_t msp_used,
      * The error information logged in the circular buffer is preserved after e.g. a watchdog
      * reset (system restart) if the RTE_FILTER_OFF_ENABLED != 0 and the firmware does not use
      * the RTE_FORCE_ENABLE_ALL_FILTERS to force the filter to be enabled again.
+     * The repetitions of messages counted by RTE_SUPPRESS_REPEATED are logged first -
+     * they would be lost after the logging is disabled.
      */
+    rte_flush_repeated();
     rte_set_filter(0U);
 
     shutdown_and_restart();
@@ -81,11 +81,8 @@ volatile uint32_t uwTick = 0;      	/* Variable to store millisecond ticks */
 void SysTick_Handler(void)  {       /* SysTick interrupt Handler. */
     ++uwTick;                       /* See startup file startup_LPC17xx.s for SysTick vector */
 
-    // Log the long timestamp every eight tick periods (8 ms)
-    if ((uwTick & 7u) == 0)
-    {
-        rte_long_timestamp();
-    }
+    // Log the long timestamp only when the short timestamp would become ambiguous
+    rte_long_timestamp_check();
 }
 
 void HAL_Delay(uint32_t Delay)